@@ -0,0 +1,193 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+#include <nlohmann/json.hpp>
+#include "ItemSaxParser.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const int kBenchmarkRuns = 5;
+
+/**
+ * Best wall time of kBenchmarkRuns calls, in milliseconds.
+ */
+static double BestOf(const std::function<void()> &run)
+{
+    double best = 0.0;
+    for (int i = 0; i < kBenchmarkRuns; ++i)
+    {
+        auto start = Clock::now();
+        run();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        best = (i == 0) ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+// Global operator new / delete that track live heap bytes while countAllocations is set.
+// Sizes come from the allocator, so a block freed outside the measured section is not miscounted.
+
+static std::atomic<bool> countAllocations(false);
+static std::atomic<int64_t> liveBytes(0);
+static std::atomic<int64_t> peakBytes(0);
+
+static size_t BlockSize(void *block)
+{
+#ifdef _WIN32
+    return _msize(block);
+#else
+    return malloc_usable_size(block);
+#endif
+}
+
+void *operator new(size_t size)
+{
+    void *block = std::malloc(size ? size : 1);
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    if (countAllocations.load(std::memory_order_relaxed))
+    {
+        int64_t live = liveBytes += static_cast<int64_t>(BlockSize(block));
+        int64_t peak = peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live))
+        {
+        }
+    }
+    return block;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *block) noexcept
+{
+    if (block && countAllocations.load(std::memory_order_relaxed))
+    {
+        liveBytes -= static_cast<int64_t>(BlockSize(block));
+    }
+    std::free(block);
+}
+
+void operator delete[](void *block) noexcept
+{
+    operator delete(block);
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+    operator delete(block);
+}
+
+void operator delete[](void *block, size_t) noexcept
+{
+    operator delete(block);
+}
+
+struct HeapUsage {
+    int64_t peak = 0;      // highest live heap during the run, above where it started
+    int64_t retained = 0;  // still allocated when the run returns
+};
+
+/**
+ * Heap used by one call of run. Whatever run frees that was allocated before it lowers
+ * both figures, so it should start from empty results.
+ */
+static HeapUsage MeasureHeap(const std::function<void()> &run)
+{
+    liveBytes = 0;
+    peakBytes = 0;
+    countAllocations = true;
+    run();
+    countAllocations = false;
+    HeapUsage usage;
+    usage.peak = peakBytes.load();
+    usage.retained = liveBytes.load();
+    return usage;
+}
+
+/**
+ * Reads a string in place, the way StreamPipe hands out downloaded chunks without copying the body.
+ */
+class StringReader : public std::streambuf {
+public:
+    explicit StringReader(const std::string &text)
+    {
+        char *data = const_cast<char *>(text.data());
+        setg(data, data, data + text.size());
+    }
+};
+
+int RunItemIngestBenchmark(const std::filesystem::path &itemsJson)
+{
+    std::ifstream file(itemsJson, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Failed to open " << itemsJson << std::endl;
+        return 1;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    const std::string body = buffer.str();
+
+    // DOM: the whole response is collected first, then parsed
+    nlohmann::json dom;
+    auto parseDom = [&]()
+    {
+        std::string response(body);
+        dom = nlohmann::json::parse(response);
+    };
+
+    // SAX: records are built from the chunks as they arrive
+    std::vector<SnapshotBuilder::Item> items;
+    std::string error;
+    bool parsed = true;
+    auto parseSax = [&]()
+    {
+        StringReader reader(body);
+        std::istream input(&reader);
+        parsed = ItemSaxParser::Parse(input, items, error) && parsed;
+    };
+
+    double domMs = BestOf([&]()
+    {
+        dom = nullptr;
+        parseDom();
+    });
+    double saxMs = BestOf([&]()
+    {
+        items.clear();
+        parseSax();
+    });
+    if (!parsed)
+    {
+        std::cerr << "SAX parse failed: " << error << std::endl;
+        return 1;
+    }
+
+    dom = nullptr;
+    HeapUsage domHeap = MeasureHeap(parseDom);
+    std::vector<SnapshotBuilder::Item>().swap(items);
+    HeapUsage saxHeap = MeasureHeap(parseSax);
+
+    std::cout << "[bench] items.json: " << body.size() / 1024 << " KiB, " << items.size() << " items, best of "
+              << kBenchmarkRuns << " runs" << std::endl;
+    std::cout << "[bench] DOM: " << domMs << " ms, peak " << domHeap.peak / 1024 << " KiB heap, "
+              << domHeap.retained / 1024 << " KiB retained" << std::endl;
+    std::cout << "[bench] SAX: " << saxMs << " ms, peak " << saxHeap.peak / 1024 << " KiB heap, "
+              << saxHeap.retained / 1024 << " KiB retained" << std::endl;
+    std::cout << "[bench] speedup " << domMs / std::max(saxMs, 0.001) << "x, peak heap "
+              << static_cast<double>(domHeap.peak) / std::max<int64_t>(saxHeap.peak, 1) << "x smaller" << std::endl;
+    return 0;
+}
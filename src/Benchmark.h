@@ -0,0 +1,14 @@
+#pragma once
+
+#include <filesystem>
+
+/**
+ * @brief 명령줄에서 실행하는 데이터 처리 벤치마크
+ *
+ * Each function prints its results and returns a process exit code.
+ */
+
+/**
+ * Compares parsing items.json into a DOM against streaming it through ItemSaxParser.
+ */
+int RunItemIngestBenchmark(const std::filesystem::path& itemsJson);
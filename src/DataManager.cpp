@@ -1,250 +1,897 @@
 #include "DataManager.h"
+#include "ItemSaxParser.h"
+#include "StreamPipe.h"
 #include <iostream>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <queue>
+#include <condition_variable>
 
-DataManager::DataManager() 
-    : client("ddragon.leagueoflegends.com"), itemClient("cdn.merakianalytics.com"),
-    defaultLanguage("ko_KR")  // Set default language to Korean
+static const std::string languagesUrl = "https://ddragon.leagueoflegends.com/cdn/languages.json";
+static const std::string versionsUrl = "https://ddragon.leagueoflegends.com/api/versions.json";
+static const std::string itemsUrl = "https://cdn.merakianalytics.com/riot/lol/resources/latest/en-US/items.json";
+static const std::chrono::seconds championDetailRetryDelay( 30 );
+
+/**
+ * Reads a string field, formatting numbers and treating null / missing as empty.
+ */
+static std::string JsonString(const nlohmann::json &object, const char *key)
+{
+    auto it = object.find(key);
+    if (it == object.end() || it->is_null())
+    {
+        return "";
+    }
+    if (it->is_string())
+    {
+        return it->get<std::string>();
+    }
+    return it->dump();
+}
+
+static float JsonFloat(const nlohmann::json &object, const char *key)
+{
+    auto it = object.find(key);
+    return (it != object.end() && it->is_number()) ? it->get<float>() : 0.0f;
+}
+
+static int JsonInt(const nlohmann::json &object, const char *key, int fallback)
+{
+    auto it = object.find(key);
+    return (it != object.end() && it->is_number()) ? it->get<int>() : fallback;
+}
+
+static std::vector<std::string> JsonStrings(const nlohmann::json &object, const char *key)
+{
+    std::vector<std::string> values;
+    auto it = object.find(key);
+    if (it != object.end() && it->is_array())
+    {
+        for (const auto &value : *it)
+        {
+            if (value.is_string())
+            {
+                values.push_back(value.get<std::string>());
+            }
+            else if (value.is_number())
+            {
+                values.push_back(std::to_string(value.get<int>()));
+            }
+        }
+    }
+    return values;
+}
+
+static SnapshotBuilder::Image JsonImage(const nlohmann::json &object)
+{
+    SnapshotBuilder::Image image;
+    auto it = object.find("image");
+    if (it != object.end() && it->is_object())
+    {
+        image.full = JsonString(*it, "full");
+        image.sprite = JsonString(*it, "sprite");
+        image.x = JsonInt(*it, "x", 0);
+        image.y = JsonInt(*it, "y", 0);
+        image.w = JsonInt(*it, "w", 0);
+        image.h = JsonInt(*it, "h", 0);
+    }
+    return image;
+}
+
+static DataManager::Sprite SnapshotSprite(const Snapshot &snapshot, const SnapshotImage &image)
+{
+    return DataManager::Sprite{std::string(snapshot.Str(image.sprite)), image.x, image.y, image.w, image.h};
+}
+
+DataManager::DataManager()
+    : httpCache(httpTransport, std::filesystem::current_path() / "cache" / "http", 12 * 60 * 60),
+    defaultLanguage("ko_KR"),  // Set default language to Korean
+    patchVersion("14.14.1"),  // until ResolvePatchVersion() finds the live one
+    snapshotPath(std::filesystem::current_path() / "cache" / "data.snapshot"),
+    textIndexPath(std::filesystem::current_path() / "cache" / "text.index")
 {
     // nothing
 }
 
-bool DataManager::FetchLanguageData()
+/**
+ * 시작에 필요한 데이터를 준비하는 메서드.
+ * The current patch is looked up in versions.json first, through the HTTP cache,
+ * so it is revalidated when stale and still known offline. A snapshot built for
+ * that patch is mapped and read in place. Otherwise languages, champions, items and summoner spells are
+ * fetched concurrently, each on its own worker, parsed as soon as they arrive and
+ * written to a new snapshot.
+ */
+bool DataManager::FetchStartupData()
 {
-    auto resLanguages = client.Get("/cdn/languages.json");
-    if (resLanguages && resLanguages->status == 200)
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+
+    auto startupStart = Clock::now();
+    startupTimings.clear();
+
+    auto report = [this, &elapsedMs, startupStart]()
     {
-        auto languages = nlohmann::json::parse(resLanguages->body);
-        //auto languageCount = languages.size();
-        //auto firstLanguage = languages[0].get<std::string>();
-        auto languageIds = languages.get<std::vector<std::string>>();
-        // for (auto language : languages)
-        // {
-        //     std::cout << language << std::endl;
-        // }
+        double totalMs = elapsedMs(startupStart, Clock::now());
+        for (const auto &timing : startupTimings)
+        {
+            std::cout << "[startup] " << timing.name << ": fetch " << timing.fetchMs << " ms, parse "
+                      << timing.parseMs << " ms" << std::endl;
+        }
+        std::cout << "[startup] total: " << totalMs << " ms" << std::endl;
+
+        auto cacheStats = httpCache.GetStats();
+        std::cout << "[cache] hits " << cacheStats.hits << ", misses " << cacheStats.misses
+                  << ", revalidated " << cacheStats.revalidations << ", stale " << cacheStats.staleFallbacks << std::endl;
 
+        auto transportStats = httpTransport.GetStats();
+        std::cout << "[http] requests " << transportStats.requests << ", new connections " << transportStats.connections << std::endl;
+    };
+
+    auto versionStart = Clock::now();
+    bool patchResolved = ResolvePatchVersion();
+    StageTiming versionTiming;
+    versionTiming.name = "version " + patchVersion;
+    versionTiming.fetchMs = elapsedMs(versionStart, Clock::now());
+    versionTiming.succeeded = patchResolved;
+    startupTimings.push_back(versionTiming);
+
+    if (LoadSnapshot(patchResolved))
+    {
+        StageTiming timing;
+        timing.name = "snapshot (mapped " + std::to_string(snapshot.SizeBytes()) + " bytes)";
+        timing.parseMs = elapsedMs(startupStart, Clock::now());
+        timing.succeeded = true;
+        startupTimings.push_back(timing);
+        report();
         return true;
     }
 
+    auto runStage = [this, &elapsedMs](const std::string &name, const std::string &url,
+                                       bool (DataManager::*parse)(const std::string &))
+    {
+        StageTiming timing;
+        timing.name = name;
+
+        std::string body;
+        auto fetchStart = Clock::now();
+        bool fetched = Download(url, body);
+        auto fetchEnd = Clock::now();
+        timing.fetchMs = elapsedMs(fetchStart, fetchEnd);
+
+        if (fetched)
+        {
+            timing.succeeded = (this->*parse)(body);
+            timing.parseMs = elapsedMs(fetchEnd, Clock::now());
+        }
+        return timing;
+    };
+
+    const std::string dataUrl = "https://ddragon.leagueoflegends.com/cdn/" + patchVersion + "/data/en_US/";
+
+    std::vector<std::future<StageTiming>> stages;
+    stages.push_back(std::async(std::launch::async, runStage, "languages",
+                                languagesUrl, &DataManager::ParseLanguageData));
+    stages.push_back(std::async(std::launch::async, runStage, "champions",
+                                dataUrl + "champion.json", &DataManager::ParseChampionData));
+    stages.push_back(std::async(std::launch::async, &DataManager::StreamItemData, this));
+    stages.push_back(std::async(std::launch::async, runStage, "summoner spells",
+                                dataUrl + "summoner.json", &DataManager::ParseSummonerSpellData));
+
+    bool succeeded = true;
+    for (auto &stage : stages)
+    {
+        StageTiming timing = stage.get();
+        if (!timing.succeeded)
+        {
+            std::cerr << "Failed to fetch " << timing.name << " data" << std::endl;
+            succeeded = false;
+        }
+        startupTimings.push_back(timing);
+    }
+
+    if (!succeeded && LoadSnapshot(false))
+    {
+        // offline on a new patch, the previous patch's data is better than none
+        std::cerr << "Using the snapshot for patch " << patchVersion << " until the new data can be fetched" << std::endl;
+        snapshotBuilder = SnapshotBuilder();
+        succeeded = true;
+    }
+    else if (succeeded)
+    {
+        auto buildStart = Clock::now();
+        StageTiming timing;
+        timing.name = "snapshot (rebuilt)";
+        timing.succeeded = succeeded = RebuildSnapshot();
+        timing.parseMs = elapsedMs(buildStart, Clock::now());
+        startupTimings.push_back(timing);
+    }
+
+    report();
+    return succeeded;
+}
+
+const std::vector<DataManager::StageTiming> &DataManager::GetStartupTimings() const
+{
+    return startupTimings;
+}
+
+const std::vector<std::string> &DataManager::GetLanguages() const
+{
+    return languages;
+}
+
+const std::string &DataManager::GetPatchVersion() const
+{
+    return patchVersion;
+}
+
+HttpCache::Stats DataManager::GetHttpCacheStats() const
+{
+    return httpCache.GetStats();
+}
+
+HttpTransport &DataManager::GetHttpTransport() const
+{
+    return httpTransport;
+}
+
+/**
+ * 모든 데이터 요청은 디스크 캐시를 거쳐서 가져온다.
+ */
+bool DataManager::Download(const std::string &url, std::string &body, const HttpTransport::DataCallback &onData,
+                           HttpTransport::Priority priority) const
+{
+    return httpCache.Get(url, body, onData, priority);
+}
+
+/**
+ * Sets patchVersion to the newest patch listed in versions.json. False when the list is unavailable, even from the
+ * cache, and patchVersion is left as it was.
+ */
+bool DataManager::ResolvePatchVersion()
+{
+    std::string body;
+    if (!Download(versionsUrl, body))
+    {
+        return false;
+    }
+    try
+    {
+        auto versions = nlohmann::json::parse(body);
+        if (versions.is_array() && !versions.empty() && versions.front().is_string())
+        {
+            patchVersion = versions.front().get<std::string>();  // newest first
+            return true;
+        }
+        std::cerr << "No patch versions in " << versionsUrl << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception parsing patch versions: " << e.what() << std::endl;
+    }
     return false;
 }
 
-bool DataManager::FetchChampionData() 
+/**
+ * Maps the snapshot on disk if it was built for the current patch. When the patch could not be resolved the
+ * snapshot is used whatever its patch, which then becomes the current one.
+ */
+bool DataManager::LoadSnapshot(bool patchResolved)
 {
-    auto res = client.Get( "/cdn/14.14.1/data/en_US/champion.json" );
-    if ( res && res->status == 200 ) 
+    if (!snapshot.Open(snapshotPath))
+    {
+        return false;
+    }
+    if (!patchResolved && !snapshot.PatchVersion().empty())
+    {
+        patchVersion = std::string(snapshot.PatchVersion());
+    }
+    if (snapshot.PatchVersion() != patchVersion || snapshot.Champions().empty() || snapshot.Items().empty())
     {
-        championData = nlohmann::json::parse( res->body );
-        ProcessChampionData();
+        std::cout << "Snapshot is for patch " << snapshot.PatchVersion() << ", rebuilding for " << patchVersion << std::endl;
+        snapshot.Close();
+        return false;
+    }
+    ProcessSnapshot();
+    return true;
+}
+
+/**
+ * Serializes the records collected by the startup stages and maps the result.
+ * If the file cannot be written the snapshot is kept in memory instead.
+ */
+bool DataManager::RebuildSnapshot()
+{
+    snapshotBuilder.SetPatchVersion(patchVersion);
+    std::vector<unsigned char> bytes = snapshotBuilder.Build();
+    snapshotBuilder = SnapshotBuilder();
+
+    itemStore.Clear();  // points into the snapshot being replaced
+    snapshot.Close();
+    if (!SnapshotBuilder::WriteFile(snapshotPath, bytes) || !snapshot.Open(snapshotPath))
+    {
+        if (!snapshot.Adopt(std::move(bytes)))
+        {
+            std::cerr << "Failed to build snapshot" << std::endl;
+            return false;
+        }
+    }
+    ProcessSnapshot();
+    return true;
+}
+
+void DataManager::ProcessSnapshot()
+{
+    languages.clear();
+    for (const auto &language : snapshot.Languages())
+    {
+        languages.emplace_back(snapshot.Str(language));
+    }
+
+    ProcessChampionData();
+    ProcessItemData();
+
+    summonerSpells.clear();
+    for (const auto &record : snapshot.Spells())
+    {
+        SummonerSpell spell;
+        spell.id = snapshot.Str(record.id);
+        spell.name = snapshot.Str(record.name);
+        spell.description = snapshot.Str(record.description);
+        for (const auto &mode : snapshot.Strings(record.modes))
+        {
+            spell.modes.emplace_back(snapshot.Str(mode));
+        }
+        spell.cooldownBurn = snapshot.Str(record.cooldownBurn);
+        spell.summonerLevel = record.summonerLevel;
+        spell.sprite = SnapshotSprite(snapshot, record.image);
+        summonerSpells.push_back(spell);
+    }
+    IndexSummonerSpells();
+}
+
+bool DataManager::ParseLanguageData(const std::string &body)
+{
+    try
+    {
+        snapshotBuilder.SetLanguages(nlohmann::json::parse(body).get<std::vector<std::string>>());
         return true;
     }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception parsing language data: " << e.what() << std::endl;
+    }
+    return false;
+}
+
+bool DataManager::ParseChampionData( const std::string& body )
+{
+    try
+    {
+        auto championData = nlohmann::json::parse( body );
 
-    std::cerr << "Failed to fetch champion data" << std::endl;
+        std::vector<SnapshotBuilder::Champion> champions;
+        for ( const auto& [key, value] : championData["data"].items() )
+        {
+            SnapshotBuilder::Champion champion;
+            champion.id = key;
+            champion.key = JsonString( value, "key" );
+            champion.name = JsonString( value, "name" );
+            champion.title = JsonString( value, "title" );
+            champion.tags = JsonStrings( value, "tags" );
+            champion.image = JsonImage( value );
+            if ( value.contains( "stats" ) )
+            {
+                for ( size_t i = 0; i < kChampionStatCount; ++i )
+                {
+                    champion.stats[i] = JsonFloat( value["stats"], kChampionStatNames[i] );
+                }
+            }
+            champions.push_back( std::move( champion ) );
+        }
+        snapshotBuilder.SetChampions( std::move( champions ) );
+        return true;
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << "Exception parsing champion data: " << e.what() << std::endl;
+    }
     return false;
 }
 
 
 /**
- * ~/cdn/14.14.1/data/{regionId}/champion/{championId}.json 에서 특정 챔피언의 데이터를 가져오는 메서드.
+ * ~/cdn/{version}/data/{regionId}/champion/{championId}.json 에서 특정 챔피언의 데이터를 가져오는 메서드.
  */
-bool DataManager::FetchSpecificChampionData( const std::string& championId ) const 
+bool DataManager::FetchSpecificChampionData( const std::string& championId ) const
 {
-    if ( specificChampionData.find( championId ) != specificChampionData.end() )
+    size_t index = FindChampionIndex( championId );
+    if ( index < championDetails.size() && championDetails[index].load( std::memory_order_acquire ) )
     {
         return true;  // Data already fetched
     }
 
-    auto res = client.Get( ("/cdn/14.14.1/data/en_US/champion/" + championId + ".json").c_str() );
-    if ( res && res->status == 200 )
+    std::string body;
+    if ( Download( "https://ddragon.leagueoflegends.com/cdn/" + patchVersion + "/data/en_US/champion/" + championId + ".json", body ) )
     {
-        specificChampionData[championId] = nlohmann::json::parse( res->body );
-        return true;
+        return ParseSpecificChampionData( championId, body );
     }
 
     std::cerr << "Failed to fetch specific champion data for " << championId << std::endl;
     return false;
 }
 
+/**
+ * 모든 챔피언의 상세 데이터를 미리 가져오는 메서드.
+ * At most maxConcurrentFetches downloads are in flight at once. Finished bodies
+ * are queued for a pool of parse workers sized to the machine, so parsing runs
+ * on every core while the remaining downloads are still pending.
+ */
+bool DataManager::PrefetchChampionDetails( size_t maxConcurrentFetches ) const
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    std::vector<std::string> pending;
+    for ( size_t i = 0; i < championRecords.size(); ++i )
+    {
+        if ( !championDetails[i].load( std::memory_order_acquire ) )
+        {
+            pending.push_back( championRecords[i].id );
+        }
+    }
+    if ( pending.empty() )
+    {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock( championRequestMutex );
+        championPrefetchRunning = true;
+    }
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::queue<std::pair<std::string, std::string>> parseQueue;
+    size_t fetchersRunning = std::min( std::max<size_t>( maxConcurrentFetches, 1 ), pending.size() );
+    size_t parserCount = std::max( 1u, std::thread::hardware_concurrency() );
+    std::atomic<size_t> nextIndex( 0 );
+    std::atomic<size_t> failures( 0 );
 
-void DataManager::ProcessChampionData() 
+    // champions the GUI is waiting for jump the queue and go out at Visible
+    auto takeUrgent = [&]( size_t& index )
+    {
+        std::lock_guard<std::mutex> lock( championRequestMutex );
+        if ( urgentChampionDetails.empty() )
+        {
+            return false;
+        }
+        index = urgentChampionDetails.front();
+        urgentChampionDetails.pop_front();
+        return true;
+    };
+
+    auto fetchWorker = [&]()
+    {
+        for ( size_t i = nextIndex++; i < pending.size(); i = nextIndex++ )
+        {
+            for ( size_t urgent; takeUrgent( urgent ); )
+            {
+                FetchChampionDetails( urgent, HttpTransport::Priority::Visible );
+            }
+            size_t index = FindChampionIndex( pending[i] );
+            if ( index < championDetails.size() && championDetails[index].load( std::memory_order_acquire ) )
+            {
+                continue;  // an urgent fetch got there first
+            }
+
+            // nobody waits on these, they yield to anything the GUI draws
+            std::string body;
+            if ( !Download( "https://ddragon.leagueoflegends.com/cdn/" + patchVersion + "/data/en_US/champion/" + pending[i] + ".json", body,
+                            nullptr, HttpTransport::Priority::Background ) )
+            {
+                std::cerr << "Failed to fetch specific champion data for " << pending[i] << std::endl;
+                ++failures;
+                continue;
+            }
+            std::lock_guard<std::mutex> lock( queueMutex );
+            parseQueue.emplace( pending[i], std::move( body ) );
+            queueReady.notify_one();
+        }
+        std::lock_guard<std::mutex> lock( queueMutex );
+        if ( --fetchersRunning == 0 )
+        {
+            queueReady.notify_all();
+        }
+    };
+
+    auto parseWorker = [&]()
+    {
+        for ( ;; )
+        {
+            std::pair<std::string, std::string> job;
+            {
+                std::unique_lock<std::mutex> lock( queueMutex );
+                queueReady.wait( lock, [&]() { return !parseQueue.empty() || fetchersRunning == 0; } );
+                if ( parseQueue.empty() )
+                {
+                    return;
+                }
+                job = std::move( parseQueue.front() );
+                parseQueue.pop();
+            }
+            if ( !ParseSpecificChampionData( job.first, job.second ) )
+            {
+                ++failures;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for ( size_t i = 0, count = fetchersRunning; i < count; ++i )
+    {
+        workers.emplace_back( fetchWorker );
+    }
+    for ( size_t i = 0; i < parserCount; ++i )
+    {
+        workers.emplace_back( parseWorker );
+    }
+    for ( auto& worker : workers )
+    {
+        worker.join();
+    }
+    {
+        // requests that arrived after the last worker looked get a fetch of their own
+        std::lock_guard<std::mutex> lock( championRequestMutex );
+        championPrefetchRunning = false;
+        for ( size_t index : urgentChampionDetails )
+        {
+            StartChampionDetailFetch( index );
+        }
+        urgentChampionDetails.clear();
+    }
+
+    std::cout << "[prefetch] " << pending.size() - failures << "/" << pending.size() << " champion details in "
+              << std::chrono::duration<double, std::milli>( Clock::now() - start ).count() << " ms" << std::endl;
+    return failures == 0;
+}
+
+static DataManager::ChampionAbility JsonAbility( const nlohmann::json& value )
 {
-    championNames.clear();
-    championNameToIdMap.clear();
-    for ( auto& [key, value] : championData["data"].items() )
+    DataManager::ChampionAbility ability;
+    ability.name = JsonString( value, "name" );
+    ability.description = JsonString( value, "description" );
+    auto image = value.find( "image" );
+    if ( image != value.end() && image->is_object() )
     {
-        std::string name = value["name"];
-        championNames.push_back( name );
-        championNameToIdMap[name] = key;
+        ability.image = JsonString( *image, "full" );
+        ability.sprite.sheet = JsonString( *image, "sprite" );
+        ability.sprite.x = JsonInt( *image, "x", 0 );
+        ability.sprite.y = JsonInt( *image, "y", 0 );
+        ability.sprite.w = JsonInt( *image, "w", 0 );
+        ability.sprite.h = JsonInt( *image, "h", 0 );
     }
+    return ability;
 }
 
-const std::vector<std::string>& DataManager::GetChampionNames() const 
+/**
+ * Turns data.{championId} of the detail file into ChampionDetails and publishes it.
+ * The first thread to finish wins, later duplicates are dropped.
+ */
+bool DataManager::ParseSpecificChampionData( const std::string& championId, const std::string& body ) const
 {
-    return championNames;
+    size_t index = FindChampionIndex( championId );
+    if ( index >= championDetails.size() )
+    {
+        std::cerr << "Unknown champion id " << championId << std::endl;
+        return false;
+    }
+
+    auto details = std::make_unique<ChampionDetails>();
+    try
+    {
+        auto json = nlohmann::json::parse( body );
+        const auto& data = json.at( "data" ).at( championId );
+
+        details->lore = JsonString( data, "lore" );
+        details->allyTips = JsonStrings( data, "allytips" );
+        details->enemyTips = JsonStrings( data, "enemytips" );
+        if ( data.contains( "passive" ) )
+        {
+            details->passive = JsonAbility( data.at( "passive" ) );
+        }
+        for ( const auto& spell : data.value( "spells", nlohmann::json::array() ) )
+        {
+            details->spells.push_back( JsonAbility( spell ) );
+        }
+        for ( const auto& skin : data.value( "skins", nlohmann::json::array() ) )
+        {
+            ChampionSkin record;
+            record.name = JsonString( skin, "name" );
+            record.num = JsonString( skin, "num" );
+            record.textureKey = championId + "_" + record.num;
+            details->skins.push_back( std::move( record ) );
+        }
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << "Exception parsing specific champion data for " << championId << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock( championDetailStoreMutex );
+    if ( !championDetails[index].load( std::memory_order_acquire ) )
+    {
+        championDetails[index].store( details.get(), std::memory_order_release );
+        championDetailStore.push_back( std::move( details ) );
+    }
+    return true;
 }
 
-std::string DataManager::GetChampionId( const std::string& championName ) const
+void DataManager::ProcessChampionData()
 {
-    auto it = championNameToIdMap.find( championName );
-    if ( it != championNameToIdMap.end() ) 
+    championNames.clear();
+    championNameToIdMap.clear();
+    championRecords.clear();
+    championDetailStore.clear();
+    for ( const auto& champion : snapshot.Champions() )
     {
-        return it->second;
+        ChampionRecord record;
+        record.id = snapshot.Str( champion.id );
+        record.key = snapshot.Str( champion.key );
+        record.name = snapshot.Str( champion.name );
+        record.title = snapshot.Str( champion.title );
+        for ( const auto& tag : snapshot.Strings( champion.tags ) )
+        {
+            record.tags.emplace_back( snapshot.Str( tag ) );
+        }
+        std::copy( std::begin( champion.stats ), std::end( champion.stats ), record.stats );
+        record.sprite = SnapshotSprite( snapshot, champion.image );
+
+        championNames.push_back( record.name );
+        championNameToIdMap[record.name] = record.id;
+        championRecords.push_back( std::move( record ) );
     }
+    std::vector<std::atomic<const ChampionDetails*>>( championRecords.size() ).swap( championDetails );
+    championDetailRequests.assign( championRecords.size(), ChampionDetailRequest() );
+    championSearchIndex.Build( championNames );
+}
 
-    return championName; // Fallback to the name if ID is not found
+/**
+ * Snapshot champions are sorted by id and the records follow the same order.
+ */
+size_t DataManager::FindChampionIndex( const std::string& championId ) const
+{
+    const SnapshotChampion* champion = snapshot.FindChampion( championId );
+    return champion ? static_cast<size_t>( champion - snapshot.Champions().begin() ) : championRecords.size();
 }
 
-std::string DataManager::GetChampionImageUrl( const std::string& championId ) const 
+const std::vector<std::string>& DataManager::GetChampionNames() const
 {
-    return "https://ddragon.leagueoflegends.com/cdn/img/champion/splash/" + championId + "_0.jpg";
+    return championNames;
 }
 
-std::string DataManager::GetChampionIconUrl( const std::string& championId ) const 
+const SearchIndex& DataManager::GetChampionSearchIndex() const
 {
-    return "http://ddragon.leagueoflegends.com/cdn/14.14.1/img/champion/" + championId + ".png";
+    return championSearchIndex;
 }
 
-nlohmann::json DataManager::GetChampionStats( const std::string& championName ) const 
+const std::vector<DataManager::ChampionRecord>& DataManager::GetChampionRecords() const
 {
-    std::string championId = GetChampionId( championName );
-    FetchSpecificChampionData( championId );
-    return specificChampionData.at( championId )["data"][championId]["stats"];
+    return championRecords;
 }
 
-std::string DataManager::GetChampionTitle( const std::string& championName ) const 
+const DataManager::ChampionRecord* DataManager::GetChampionRecord( const std::string& championName ) const
 {
-    std::string championId = GetChampionId( championName );
-    return championData["data"][championId]["title"];
+    auto it = championNameToIdMap.find( championName );
+    if ( it == championNameToIdMap.end() )
+    {
+        return nullptr;
+    }
+    size_t index = FindChampionIndex( it->second );
+    return index < championRecords.size() ? &championRecords[index] : nullptr;
 }
 
-std::string DataManager::GetChampionLore( const std::string& championName ) const {
-    std::string championId = GetChampionId( championName);
-    FetchSpecificChampionData( championId );
-    return specificChampionData.at(championId)["data"][championId]["lore"];
+/**
+ * Returns the champion's details, or nullptr while they are still on the way. Called every
+ * frame, so it never blocks: a missing champion is requested once and shows up on a later frame.
+ */
+const DataManager::ChampionDetails* DataManager::GetChampionDetails( const ChampionRecord& champion ) const
+{
+    size_t index = static_cast<size_t>( &champion - championRecords.data() );
+    if ( index >= championRecords.size() )
+    {
+        return nullptr;
+    }
+    const ChampionDetails* details = championDetails[index].load( std::memory_order_acquire );
+    if ( !details )
+    {
+        RequestChampionDetails( index );
+    }
+    return details;
 }
 
-std::vector<std::string> DataManager::GetChampionTags( const std::string& championName ) const {
-    std::string championId = GetChampionId( championName );
-    return championData["data"][championId]["tags"].get<std::vector<std::string>>();
+/**
+ * Puts the champion in front of the prefetch, unless it is already requested or failed recently.
+ */
+void DataManager::RequestChampionDetails( size_t index ) const
+{
+    std::lock_guard<std::mutex> lock( championRequestMutex );
+    auto& request = championDetailRequests[index];
+    if ( request.requested || std::chrono::steady_clock::now() < request.retryAt )
+    {
+        return;
+    }
+    request.requested = true;
+    if ( championPrefetchRunning )
+    {
+        urgentChampionDetails.push_back( index );
+    }
+    else
+    {
+        StartChampionDetailFetch( index );
+    }
+}
+
+/**
+ * Fetches one champion on its own thread. Caller holds championRequestMutex.
+ */
+void DataManager::StartChampionDetailFetch( size_t index ) const
+{
+    championDetailFetches.erase( std::remove_if( championDetailFetches.begin(), championDetailFetches.end(),
+                                                 []( const std::future<void>& fetch )
+                                                 { return fetch.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready; } ),
+                                 championDetailFetches.end() );
+    championDetailFetches.push_back( std::async( std::launch::async, [this, index]()
+                                                 { FetchChampionDetails( index, HttpTransport::Priority::Visible ); } ) );
 }
 
-nlohmann::json DataManager::GetChampionSpells(const std::string &championName) const
+/**
+ * Downloads and publishes one champion's details, then settles its request.
+ */
+bool DataManager::FetchChampionDetails( size_t index, HttpTransport::Priority priority ) const
 {
-    std::string championId = GetChampionId(championName);
-    FetchSpecificChampionData(championId);
-    return specificChampionData.at(championId)["data"][championId]["spells"];
+    const std::string& championId = championRecords[index].id;
+    std::string body;
+    bool ok = championDetails[index].load( std::memory_order_acquire ) ||
+              ( Download( "https://ddragon.leagueoflegends.com/cdn/" + patchVersion + "/data/en_US/champion/" + championId + ".json", body,
+                          nullptr, priority ) &&
+                ParseSpecificChampionData( championId, body ) );
+    if ( !ok )
+    {
+        std::cerr << "Failed to fetch specific champion data for " << championId << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock( championRequestMutex );
+    auto& request = championDetailRequests[index];
+    request.requested = false;
+    if ( !ok )
+    {
+        request.retryAt = std::chrono::steady_clock::now() + championDetailRetryDelay;
+    }
+    return ok;
 }
 
-nlohmann::json DataManager::GetChampionPassive(const std::string &championName) const
+std::string DataManager::GetChampionId( const std::string& championName ) const
 {
-    std::string championId = GetChampionId(championName);
-    FetchSpecificChampionData(championId);
-    return specificChampionData.at(championId)["data"][championId]["passive"];
+    auto it = championNameToIdMap.find( championName );
+    if ( it != championNameToIdMap.end() )
+    {
+        return it->second;
+    }
+
+    return championName; // Fallback to the name if ID is not found
 }
 
-nlohmann::json DataManager::GetChampionData(const std::string &championId) const
+std::string DataManager::GetChampionImageUrl( const std::string& championId ) const
 {
-    return championData["data"][championId];
+    return "https://ddragon.leagueoflegends.com/cdn/img/champion/splash/" + championId + "_0.jpg";
 }
 
-nlohmann::json DataManager::GetChampionSkins(const std::string &championName) const
+std::string DataManager::GetChampionTileUrl( const std::string& championId ) const
 {
-    std::string championId = GetChampionId(championName);
-    FetchSpecificChampionData(championId);
-    return specificChampionData.at(championId)["data"][championId]["skins"];
+    return "https://ddragon.leagueoflegends.com/cdn/img/champion/tiles/" + championId + "_0.jpg";
 }
 
-std::string DataManager::GetChampionSkinImageUrl(const std::string &championId, const std::string &skinNum) const
+std::string DataManager::GetChampionIconUrl( const std::string& championId ) const
 {
-    return "https://ddragon.leagueoflegends.com/cdn/img/champion/splash/" + championId + "_" + skinNum + ".jpg";
+    return "http://ddragon.leagueoflegends.com/cdn/" + patchVersion + "/img/champion/" + championId + ".png";
 }
 
-std::vector<std::string> DataManager::GetChampionAllyTips(const std::string &championName) const
+std::string DataManager::GetSpriteUrl( const std::string& sheet ) const
 {
-    std::string championId = GetChampionId(championName);
-    FetchSpecificChampionData(championId);
-    return specificChampionData.at(championId)["data"][championId]["allytips"].get<std::vector<std::string>>();
+    return "https://ddragon.leagueoflegends.com/cdn/" + patchVersion + "/img/sprite/" + sheet;
 }
 
-std::vector<std::string> DataManager::GetChampionEnemyTips(const std::string &championName) const
+std::string DataManager::GetChampionSkinImageUrl(const std::string &championId, const std::string &skinNum) const
 {
-    std::string championId = GetChampionId(championName);
-    FetchSpecificChampionData(championId);
-    return specificChampionData.at(championId)["data"][championId]["enemytips"].get<std::vector<std::string>>();
+    return "https://ddragon.leagueoflegends.com/cdn/img/champion/splash/" + championId + "_" + skinNum + ".jpg";
 }
 
 // item window functions
-bool DataManager::FetchItemData()
+/**
+ * items.json 을 내려받는 동안 바로 아이템 레코드로 읽는 메서드.
+ * The body is streamed into ItemSaxParser as it arrives, so no DOM is built and
+ * parsing overlaps the download. parseMs is only the part left after the last byte.
+ */
+DataManager::StageTiming DataManager::StreamItemData()
 {
-    auto res = itemClient.Get("/riot/lol/resources/latest/en-US/items.json");
-    if (res && res->status == 200)
+    using Clock = std::chrono::steady_clock;
+    StageTiming timing;
+    timing.name = "items";
+
+    StreamPipe pipe;
+    Clock::time_point fetchStart = Clock::now();
+    Clock::time_point fetchEnd = fetchStart;
+    auto download = std::async(std::launch::async, [this, &pipe, &fetchEnd]()
     {
-        try
+        std::string body;
+        bool fetched = Download(itemsUrl, body, [&pipe](const char *data, size_t size)
         {
-            itemData = nlohmann::json::parse(res->body);
-            ProcessItemData();
-            // std::cout << "Loaded " << itemData.size() << " items" << std::endl;
-            return true;
-        }
-        catch (const std::exception &e)
-        {
-            std::cerr << "Exception parsing item data: " << e.what() << std::endl;
-        }
-    }
-    std::cerr << "Failed to fetch item data" << std::endl;
-    return false;
-}
+            pipe.Write(data, size);
+        });
+        fetchEnd = Clock::now();
+        pipe.Close();
+        return fetched;
+    });
 
-bool DataManager::FetchSpecificItemData(const std::string &itemId) const
-{
-    // Check if we already have this item's data
-    if (specificItemData.find(itemId) != specificItemData.end())
+    std::vector<SnapshotBuilder::Item> items;
+    std::string error;
+    std::istream input(&pipe);
+    bool parsed = ItemSaxParser::Parse(input, items, error);
+    Clock::time_point parseEnd = Clock::now();
+    bool fetched = download.get();
+
+    timing.fetchMs = std::chrono::duration<double, std::milli>(fetchEnd - fetchStart).count();
+    timing.parseMs = std::max(0.0, std::chrono::duration<double, std::milli>(parseEnd - fetchEnd).count());
+    if (fetched && !parsed)
     {
-        return true; // Data already fetched
+        std::cerr << "Exception parsing item data: " << error << std::endl;
     }
-    // Check if we have already loaded the entire item data
-    if (itemData.empty())
+
+    timing.succeeded = fetched && parsed;
+    if (timing.succeeded)
     {
-        // If not, fetch the entire item data
-        auto res = itemClient.Get("/riot/lol/resources/latest/en-US/items.json");
-        if (!res || res->status != 200)
-        {
-            std::cerr << "Failed to fetch item data" << std::endl;
-            return false;
-        }
-        itemData = nlohmann::json::parse(res->body);
+        snapshotBuilder.SetItems(std::move(items));
     }
-    // Search for the specific item in the itemData
-    auto it = itemData.find(itemId);
-    if (it != itemData.end())
+    return timing;
+}
+
+bool DataManager::FetchSpecificItemData(const std::string &itemId) const
+{
+    if (itemStore.Find(itemId) != kInvalidItem)
     {
-        // Store the specific item data
-        specificItemData[itemId] = *it;
-        // Update itemNames and itemNameToIdMap if not already present
-        std::string itemName = (*it)["name"];
-        if (std::find(itemNames.begin(), itemNames.end(), itemName) == itemNames.end())
-        {
-            itemNames.push_back(itemName);
-            itemNameToIdMap[itemName] = itemId;
-        }
         return true;
     }
-    else
-    {
-        std::cerr << "Item ID " << itemId << " not found in item data" << std::endl;
-        return false;
-    }
+    std::cerr << "Item ID " << itemId << " not found in item data" << std::endl;
+    return false;
 }
 
 void DataManager::ProcessItemData()
 {
+    itemStore.Build(snapshot);
     itemNames.clear();
-    itemNameToIdMap.clear();
-    for (auto &[key, value] : itemData.items())
+    for (ItemHandle item = 0; item < itemStore.Size(); ++item)
     {
-        std::string name = value["name"];
-        itemNames.push_back(name);
-        itemNameToIdMap[name] = key;
+        itemNames.emplace_back(itemStore.Name(item));
     }
+    itemSearchIndex.Build(itemNames);
+
+    validTagMask = 0;
+    for (const auto &tag : validTags)
+    {
+        validTagMask |= itemStore.TagBit(tag);
+    }
+}
+
+const ItemStore &DataManager::GetItemStore() const
+{
+    return itemStore;
 }
 
 const std::vector<std::string> &DataManager::GetItemNames() const
@@ -252,74 +899,63 @@ const std::vector<std::string> &DataManager::GetItemNames() const
     return itemNames;
 }
 
-std::vector<std::string> DataManager::GetItemsByTag(const std::string &tag) const
+const SearchIndex &DataManager::GetItemSearchIndex() const
 {
-    std::vector<std::string> itemsWithTag;
-    try
-    {
-        for (const auto &[itemId, itemData] : itemData.items())
-        {
-            if (itemData.contains("shop") && itemData["shop"].contains("tags"))
-            {
-                const auto &tags = itemData["shop"]["tags"];
-                if (std::find(tags.begin(), tags.end(), tag) != tags.end())
-                {
-                    itemsWithTag.push_back(itemId);
-                }
-            }
-        }
-        std::cout << "Found " << itemsWithTag.size() << " items with tag: " << tag << std::endl;
-    }
-    catch (const std::exception &e)
-    {
-        std::cerr << "Exception in GetItemsByTag: " << e.what() << std::endl;
-    }
-    return itemsWithTag;
+    return itemSearchIndex;
+}
+
+Span<ItemHandle> DataManager::GetItemsByTag(const std::string &tag) const
+{
+    return itemStore.ItemsWithTag(tag);
+}
+
+std::vector<ItemHandle> DataManager::GetItemsWithAllTags(const std::vector<std::string> &tags) const
+{
+    return itemStore.ItemsWithAllTags(tags);
+}
+
+std::vector<ItemHandle> DataManager::GetItemsWithAnyTag(const std::vector<std::string> &tags) const
+{
+    return itemStore.ItemsWithAnyTag(tags);
 }
 
 std::string DataManager::GetItemImageUrl(const std::string &itemId) const
 {
-    return itemData[itemId]["icon"];
+    ItemHandle item = itemStore.Find(itemId);
+    return item != kInvalidItem ? std::string(itemStore.IconUrl(item)) : std::string();
 }
 
 std::string DataManager::GetItemId(const std::string &itemName) const
 {
-    auto it = itemNameToIdMap.find(itemName);
-    if (it != itemNameToIdMap.end())
+    ItemHandle item = itemStore.FindByName(itemName);
+    if (item != kInvalidItem)
     {
-        return it->second;
+        return itemStore.Id(item);
     }
     return itemName; // Fallback to the name if ID is not found
 }
 
 std::string DataManager::GetSpecificItemName(const std::string &itemId) const
 {
-    if (itemData.contains(itemId))
-    {
-        return itemData[itemId]["name"];
-    }
-    return "Unknown Item";
+    ItemHandle item = itemStore.Find(itemId);
+    return item != kInvalidItem ? std::string(itemStore.Name(item)) : "Unknown Item";
 }
 
 std::string DataManager::GetItemDescription(const std::string &itemId) const
 {
-    if (itemData.contains(itemId) && itemData[itemId].contains("simpleDescription"))
-    {
-        if (itemData[itemId].at("simpleDescription") != nullptr)
-            return itemData[itemId]["simpleDescription"];
-    }
-    return "No description available";
+    ItemHandle item = itemStore.Find(itemId);
+    return item != kInvalidItem ? std::string(itemStore.Description(item)) : ItemStore::kMissingDescription;
 }
 
 std::vector<std::string> DataManager::GetItemBuildsFrom(const std::string &itemId) const
 {
-    FetchSpecificItemData(itemId);
     std::vector<std::string> buildsFrom;
-    if (specificItemData.at(itemId).contains("buildsFrom"))
+    ItemHandle item = itemStore.Find(itemId);
+    if (item != kInvalidItem)
     {
-        for (const auto &item : specificItemData.at(itemId)["buildsFrom"])
+        for (ItemHandle buildItem : itemStore.BuildsFrom(item))
         {
-            buildsFrom.push_back(item.get<std::string>());
+            buildsFrom.emplace_back(itemStore.Id(buildItem));
         }
     }
     return buildsFrom;
@@ -328,165 +964,81 @@ std::vector<std::string> DataManager::GetItemBuildsFrom(const std::string &itemI
 std::vector<std::string> DataManager::GetItemBuildsInto(const std::string &itemId) const
 {
     std::vector<std::string> buildsInto;
-    try
+    ItemHandle item = itemStore.Find(itemId);
+    if (item != kInvalidItem)
     {
-        FetchSpecificItemData(itemId);
-        if (specificItemData.at(itemId).contains("buildsInto") &&
-            specificItemData.at(itemId)["buildsInto"].is_array())
+        for (ItemHandle buildItem : itemStore.BuildsInto(item))
         {
-            for (const auto &buildItem : specificItemData.at(itemId)["buildsInto"])
-            {
-                if (buildItem.is_string())
-                {
-                    buildsInto.push_back(buildItem.get<std::string>());
-                }
-                else if (buildItem.is_number())
-                {
-                    // Convert number to string
-                    buildsInto.push_back(std::to_string(buildItem.get<int>()));
-                }
-            }
+            buildsInto.emplace_back(itemStore.Id(buildItem));
         }
     }
-    catch (const std::exception &e)
-    {
-        std::cerr << "Error in GetItemBuildsInto for item " << itemId << ": " << e.what() << std::endl;
-    }
     return buildsInto;
 }
 
 int DataManager::GetItemCost(const std::string &itemId) const
 {
-    if (itemData.contains(itemId) && itemData[itemId].contains("shop") &&
-        itemData[itemId]["shop"].contains("prices") &&
-        itemData[itemId]["shop"]["prices"].contains("total"))
-    {
-        return itemData[itemId]["shop"]["prices"]["total"];
-    }
-    return -1;
+    ItemHandle item = itemStore.Find(itemId);
+    return item != kInvalidItem ? itemStore.Cost(item) : -1;
 }
 
 int DataManager::GetItemSellPrice(const std::string &itemId) const
 {
-    FetchSpecificItemData(itemId);
-    if (specificItemData.at(itemId).contains("shop") && specificItemData.at(itemId)["shop"].contains("prices"))
-    {
-        return specificItemData.at(itemId)["shop"]["prices"]["sell"].get<int>();
-    }
-    return -1; // Return a default value or handle the case where the sell price is not available
+    ItemHandle item = itemStore.Find(itemId);
+    return item != kInvalidItem ? itemStore.SellPrice(item) : -1;
 }
 
 bool DataManager::IsItemPurchasable(const std::string &itemId) const
 {
-    FetchSpecificItemData(itemId);
-    if (specificItemData.at(itemId).contains("shop"))
-    {
-        return specificItemData.at(itemId)["shop"]["purchasable"].get<bool>();
-    }
-    return false; // Default value if the key is not found
+    ItemHandle item = itemStore.Find(itemId);
+    return item != kInvalidItem && itemStore.Purchasable(item);
 }
 
 std::vector<std::string> DataManager::GetItemTags(const std::string &itemId) const
 {
     std::vector<std::string> tags;
-    if (itemData.contains(itemId) && itemData[itemId].contains("shop") &&
-        itemData[itemId]["shop"].contains("tags"))
+    ItemHandle item = itemStore.Find(itemId);
+    if (item != kInvalidItem)
     {
-        for (const auto &tag : itemData[itemId]["shop"]["tags"])
+        uint64_t mask = itemStore.TagMask(item) & validTagMask;
+        for (size_t bit = 0; mask != 0; ++bit, mask >>= 1)
         {
-            std::string tagStr = tag.get<std::string>();
-            if (validTags.find(tagStr) != validTags.end())
+            if (mask & 1)
             {
-                tags.push_back(tagStr);
+                tags.push_back(itemStore.TagNames()[bit]);
             }
         }
     }
     return tags;
 }
 
-nlohmann::json DataManager::GetItemStats(const std::string &itemId) const
-{
-    if (itemData.contains(itemId) && itemData[itemId].contains("stats"))
-    {
-        return itemData[itemId]["stats"];
-    }
-    return nlohmann::json::object();
-}
-
-nlohmann::json DataManager::GetItemData(const std::string &itemId) const
-{
-    if (itemData.contains(itemId))
-    {
-        return itemData[itemId];
-    }
-    return nlohmann::json::object();
-}
-
-nlohmann::json DataManager::GetItemShopInfo(const std::string &itemId) const
-{
-    FetchSpecificItemData(itemId);
-    if (specificItemData.at(itemId).contains("shop"))
-    {
-        return specificItemData.at(itemId)["shop"];
-    }
-    return {}; // Return an empty JSON object if the shop info is not found
-}
-
 std::vector<std::string> DataManager::GetAllItemIds() const
 {
     std::vector<std::string> ids;
-    for (const auto &[id, item] : itemData.items())
+    for (ItemHandle item = 0; item < itemStore.Size(); ++item)
     {
-        ids.push_back(id);
+        ids.emplace_back(itemStore.Id(item));
     }
     return ids;
 }
 
 std::string DataManager::GetItemIdFromIconUrl(const std::string &url) const
 {
-    for (const auto &[id, item] : itemData.items())
-    {
-        if (item["icon"] == url)
-        {
-            return id;
-        }
-    }
-    return "";
+    ItemHandle item = itemStore.FindByIconUrl(url);
+    return item != kInvalidItem ? itemStore.Id(item) : "";
 }
 
 bool DataManager::ItemExists(const std::string &itemId) const
 {
-    return itemData.contains(itemId);
+    return itemStore.Find(itemId) != kInvalidItem;
 }
 
 // Summoner spell window related functions
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb, std::string *output)
-{
-    size_t totalSize = size * nmemb;
-    output->append((char *)contents, totalSize);
-    return totalSize;
-}
-
 bool DataManager::FetchGameModes()
 {
-    CURL *curl = curl_easy_init();
-    if (!curl)
-    {
-        std::cerr << "Failed to initialize curl" << std::endl;
-        return false;
-    }
-
     std::string response;
-    curl_easy_setopt(curl, CURLOPT_URL, "https://static.developer.riotgames.com/docs/lol/gameModes.json");
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK)
+    if (!Download("https://static.developer.riotgames.com/docs/lol/gameModes.json", response))
     {
-        std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
+        std::cerr << "Failed to fetch game modes" << std::endl;
         return false;
     }
 
@@ -500,6 +1052,12 @@ bool DataManager::FetchGameModes()
             gameModes.push_back({mode["gameMode"].get<std::string>(),
                                  mode["description"].get<std::string>()});
         }
+        std::vector<std::string> modeNames;
+        for (const auto &gameMode : gameModes)
+        {
+            modeNames.push_back(gameMode.mode);
+        }
+        gameModeSearchIndex.Build(modeNames);
         std::cout << "Successfully fetched " << gameModes.size() << " game modes" << std::endl;
         return true;
     }
@@ -515,42 +1073,75 @@ const std::vector<DataManager::GameMode> &DataManager::GetGameModes() const
     return gameModes;
 }
 
+const SearchIndex &DataManager::GetGameModeSearchIndex() const
+{
+    return gameModeSearchIndex;
+}
+
+/**
+ * Summoner spells come from the snapshot at startup, so this only fetches when it is missing.
+ */
 bool DataManager::FetchSummonerSpells()
 {
-    CURL *curl = curl_easy_init();
-    if (curl)
+    if (!summonerSpells.empty())
     {
-        std::string url = "https://ddragon.leagueoflegends.com/cdn/14.14.1/data/en_US/summoner.json";
-        std::string response;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+        return true;
+    }
 
-        if (res == CURLE_OK)
+    std::string response;
+    if (Download("https://ddragon.leagueoflegends.com/cdn/" + patchVersion + "/data/en_US/summoner.json", response))
+    {
+        auto json = nlohmann::json::parse(response);
+        summonerSpells.clear();
+        for (const auto &[key, value] : json["data"].items())
         {
-            auto json = nlohmann::json::parse(response);
-            summonerSpells.clear();
-            for (const auto &[key, value] : json["data"].items())
-            {
-                SummonerSpell spell;
-                spell.id = value["id"];
-                spell.name = value["name"];
-                spell.description = value["description"];
-                spell.modes = value["modes"].get<std::vector<std::string>>();
-                spell.cooldownBurn = value["cooldownBurn"];
-                spell.summonerLevel = value["summonerLevel"];
-                summonerSpells.push_back(spell);
-            }
-            return true;
+            SummonerSpell spell;
+            spell.id = value["id"];
+            spell.name = value["name"];
+            spell.description = value["description"];
+            spell.modes = value["modes"].get<std::vector<std::string>>();
+            spell.cooldownBurn = value["cooldownBurn"];
+            spell.summonerLevel = value["summonerLevel"];
+            SnapshotBuilder::Image image = JsonImage(value);
+            spell.sprite = DataManager::Sprite{image.sprite, image.x, image.y, image.w, image.h};
+            summonerSpells.push_back(spell);
         }
+        IndexSummonerSpells();
+        return true;
     }
     std::cerr << "Failed to fetch summoner spells" << std::endl;
     return false;
 }
 
+bool DataManager::ParseSummonerSpellData(const std::string &body)
+{
+    try
+    {
+        auto json = nlohmann::json::parse(body);
+
+        std::vector<SnapshotBuilder::Spell> spells;
+        for (const auto &[key, value] : json["data"].items())
+        {
+            SnapshotBuilder::Spell spell;
+            spell.id = JsonString(value, "id");
+            spell.name = JsonString(value, "name");
+            spell.description = JsonString(value, "description");
+            spell.cooldownBurn = JsonString(value, "cooldownBurn");
+            spell.summonerLevel = JsonInt(value, "summonerLevel", 0);
+            spell.modes = JsonStrings(value, "modes");
+            spell.image = JsonImage(value);
+            spells.push_back(std::move(spell));
+        }
+        snapshotBuilder.SetSpells(std::move(spells));
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception parsing summoner spell data: " << e.what() << std::endl;
+    }
+    return false;
+}
+
 const std::vector<DataManager::SummonerSpell> &DataManager::GetSummonerSpells() const
 {
     return summonerSpells;
@@ -572,3 +1163,151 @@ std::vector<DataManager::SummonerSpell> DataManager::GetSummonerSpellsForMode(co
     }
     return filteredSpells;
 }
+
+void DataManager::IndexSummonerSpells()
+{
+    std::vector<std::string> names;
+    for (const auto &spell : summonerSpells)
+    {
+        names.push_back(spell.name);
+    }
+    summonerSpellSearchIndex.Build(names);
+}
+
+/**
+ * Ranks champions, items and summoner spells together by how closely their names match the query.
+ */
+std::vector<DataManager::NameMatch> DataManager::SearchNames(const std::string &query, size_t limit) const
+{
+    std::vector<NameMatch> results;
+    auto collect = [&](NameMatch::Kind kind, const SearchIndex &index, const auto &nameOf)
+    {
+        for (const auto &match : index.FuzzySearch(query, limit))
+        {
+            results.push_back({kind, match.entry, match.distance, nameOf(match.entry)});
+        }
+    };
+    collect(NameMatch::Kind::Champion, championSearchIndex, [this](uint32_t i) { return championNames[i]; });
+    collect(NameMatch::Kind::Item, itemSearchIndex, [this](uint32_t i) { return itemNames[i]; });
+    collect(NameMatch::Kind::SummonerSpell, summonerSpellSearchIndex, [this](uint32_t i) { return summonerSpells[i].name; });
+
+    std::stable_sort(results.begin(), results.end(), [](const NameMatch &a, const NameMatch &b)
+                     { return a.distance < b.distance; });
+    if (results.size() > limit)
+    {
+        results.resize(limit);
+    }
+    return results;
+}
+
+/**
+ * Maps the persisted index if it was built for the current patch. Otherwise every
+ * champion detail file is loaded, the text is indexed on all cores and the result
+ * is written next to the snapshot.
+ */
+void DataManager::PrepareTextIndex() const
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    if (textIndex.Load(textIndexPath, patchVersion))
+    {
+        std::cout << "[text] loaded " << textIndex.DocumentCount() << " documents in "
+                  << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+        return;
+    }
+
+    bool complete = PrefetchChampionDetails();
+    std::vector<TextIndex::Document> documents;
+    auto add = [&](TextMatch::Field field, size_t owner, size_t part, const std::string &text)
+    {
+        if (!text.empty())
+        {
+            documents.push_back({static_cast<uint32_t>(field), static_cast<uint32_t>(owner), static_cast<uint32_t>(part), text});
+        }
+    };
+    for (size_t i = 0; i < championRecords.size(); ++i)
+    {
+        const ChampionDetails *details = championDetails[i].load(std::memory_order_acquire);
+        if (!details)
+        {
+            complete = false;
+            continue;
+        }
+        add(TextMatch::Field::Lore, i, 0, details->lore);
+        add(TextMatch::Field::Passive, i, 0, details->passive.description);
+        for (size_t s = 0; s < details->spells.size(); ++s)
+        {
+            add(TextMatch::Field::Spell, i, s, details->spells[s].description);
+        }
+        for (size_t t = 0; t < details->allyTips.size(); ++t)
+        {
+            add(TextMatch::Field::AllyTip, i, t, details->allyTips[t]);
+        }
+        for (size_t t = 0; t < details->enemyTips.size(); ++t)
+        {
+            add(TextMatch::Field::EnemyTip, i, t, details->enemyTips[t]);
+        }
+    }
+    for (ItemHandle item = 0; item < itemStore.Size(); ++item)
+    {
+        if (itemStore.HasDescription(item))
+        {
+            add(TextMatch::Field::ItemDescription, item, 0, itemStore.Description(item));
+        }
+    }
+    for (size_t i = 0; i < summonerSpells.size(); ++i)
+    {
+        add(TextMatch::Field::SummonerSpellDescription, i, 0, summonerSpells[i].description);
+    }
+
+    textIndex.Build(std::move(documents), std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "[text] indexed " << textIndex.DocumentCount() << " documents in "
+              << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+    // A partial index is still searchable but is rebuilt next time rather than persisted
+    if (complete)
+    {
+        textIndex.Save(textIndexPath, patchVersion);
+    }
+}
+
+std::vector<DataManager::TextMatch> DataManager::SearchText(const std::string &query, size_t limit) const
+{
+    std::call_once(textIndexOnce, [this]() { PrepareTextIndex(); });
+
+    std::vector<TextMatch> results;
+    for (const auto &hit : textIndex.Search(query, limit))
+    {
+        const TextIndex::Document &document = textIndex.GetDocument(hit.document);
+        TextMatch match;
+        match.field = static_cast<TextMatch::Field>(document.kind);
+        match.text = document.text;
+        match.score = hit.score;
+        switch (match.field)
+        {
+        case TextMatch::Field::ItemDescription:
+            match.title = document.owner < itemNames.size() ? itemNames[document.owner] : "";
+            break;
+        case TextMatch::Field::SummonerSpellDescription:
+            match.title = document.owner < summonerSpells.size() ? summonerSpells[document.owner].name : "";
+            break;
+        default:
+            if (document.owner < championRecords.size())
+            {
+                const ChampionRecord &champion = championRecords[document.owner];
+                match.title = champion.name;
+                const ChampionDetails *details = championDetails[document.owner].load(std::memory_order_acquire);
+                if (details && match.field == TextMatch::Field::Passive)
+                {
+                    match.title += " - " + details->passive.name;
+                }
+                else if (details && match.field == TextMatch::Field::Spell && document.part < details->spells.size())
+                {
+                    match.title += " - " + details->spells[document.part].name;
+                }
+            }
+            break;
+        }
+        results.push_back(std::move(match));
+    }
+    return results;
+}
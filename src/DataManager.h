@@ -3,38 +3,104 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <future>
 #include <nlohmann/json.hpp>
-#include <httplib.h>
-#include <curl/curl.h>
+#include "HttpCache.h"
+#include "Snapshot.h"
+#include "ItemStore.h"
+#include "SearchIndex.h"
+#include "TextIndex.h"
 
 class DataManager {
 public:
     DataManager();
+
+    // Startup pipeline
+    struct StageTiming {
+        std::string name;
+        double fetchMs = 0.0;
+        double parseMs = 0.0;
+        bool succeeded = false;
+    };
+    bool FetchStartupData();
+    const std::vector<StageTiming>& GetStartupTimings() const;
+    const std::vector<std::string>& GetLanguages() const;
+    const std::string& GetPatchVersion() const;
+    HttpCache::Stats GetHttpCacheStats() const;
+    HttpTransport& GetHttpTransport() const;
+
+    /**
+     * @brief Where an icon sits inside one of the img/sprite sheets
+     */
+    struct Sprite {
+        std::string sheet;          // file name under img/sprite, empty when unknown
+        int x = 0, y = 0, w = 0, h = 0;
+
+        bool IsValid() const { return !sheet.empty() && w > 0 && h > 0; }
+    };
+    std::string GetSpriteUrl(const std::string& sheet) const;
+
     // Champion window related functions
-    bool FetchLanguageData();
-    bool FetchChampionData();
+    struct ChampionAbility {
+        std::string name;
+        std::string description;
+        std::string image;          // file name under img/passive or img/spell
+        Sprite sprite;
+    };
+    struct ChampionSkin {
+        std::string name;
+        std::string num;
+        std::string textureKey;     // {championId}_{num}
+    };
+    /**
+     * @brief Data from the champion's detail file, built once and never modified afterwards
+     */
+    struct ChampionDetails {
+        std::string lore;
+        ChampionAbility passive;
+        std::vector<ChampionAbility> spells;
+        std::vector<ChampionSkin> skins;
+        std::vector<std::string> allyTips;
+        std::vector<std::string> enemyTips;
+    };
+    struct ChampionRecord {
+        std::string id;
+        std::string key;
+        std::string name;
+        std::string title;
+        std::vector<std::string> tags;
+        float stats[kChampionStatCount] = {};
+        Sprite sprite;
+
+        float Stat(ChampionStat stat) const { return stats[static_cast<size_t>(stat)]; }
+    };
     bool FetchSpecificChampionData(const std::string& championId) const;  // Now const
+    bool PrefetchChampionDetails(size_t maxConcurrentFetches = 8) const;
     const std::vector<std::string>& GetChampionNames() const;
+    const SearchIndex& GetChampionSearchIndex() const;
+    const std::vector<ChampionRecord>& GetChampionRecords() const;
+    const ChampionRecord* GetChampionRecord(const std::string& championName) const;
+    const ChampionDetails* GetChampionDetails(const ChampionRecord& champion) const;
     std::string GetChampionId(const std::string& championName) const;
     std::string GetChampionImageUrl(const std::string& championId) const;
+    std::string GetChampionTileUrl(const std::string& championId) const;
     std::string GetChampionIconUrl(const std::string& championId) const;
-    nlohmann::json GetChampionStats(const std::string& championName) const;
-    std::string GetChampionTitle(const std::string& championName) const;
-    std::string GetChampionLore(const std::string& championName) const;
-    std::vector<std::string> GetChampionTags(const std::string& championName) const;
-    nlohmann::json GetChampionSpells(const std::string& championName) const;
-    nlohmann::json GetChampionPassive(const std::string& championName) const;
-    nlohmann::json GetChampionData(const std::string& championId) const;
-    nlohmann::json GetChampionSkins(const std::string& championName) const;
     std::string GetChampionSkinImageUrl(const std::string& championId, const std::string& skinNum) const;
-    std::vector<std::string> GetChampionAllyTips(const std::string& championName) const;
-    std::vector<std::string> GetChampionEnemyTips(const std::string& championName) const;
 
     // Item window related functions
-    bool FetchItemData();
     bool FetchSpecificItemData(const std::string& itemId) const;
+    const ItemStore& GetItemStore() const;
     const std::vector<std::string>& GetItemNames() const;
-    std::vector<std::string> GetItemsByTag(const std::string& tag) const;
+    const SearchIndex& GetItemSearchIndex() const;
+    Span<ItemHandle> GetItemsByTag(const std::string& tag) const;
+    std::vector<ItemHandle> GetItemsWithAllTags(const std::vector<std::string>& tags) const;
+    std::vector<ItemHandle> GetItemsWithAnyTag(const std::vector<std::string>& tags) const;
     std::string GetItemId(const std::string& itemName) const;
     std::string GetSpecificItemName(const std::string& itemId) const;
     std::string GetItemDescription(const std::string& itemId) const;
@@ -45,9 +111,6 @@ public:
     int GetItemSellPrice(const std::string& itemId) const;
     bool IsItemPurchasable(const std::string& itemId) const;
     std::vector<std::string> GetItemTags(const std::string& itemId) const;
-    nlohmann::json GetItemStats(const std::string& itemId) const;
-    nlohmann::json GetItemData(const std::string& itemId) const;
-    nlohmann::json GetItemShopInfo(const std::string& itemId) const;
     std::vector<std::string> GetAllItemIds() const;
     std::string GetItemIdFromIconUrl(const std::string& url) const;
     bool ItemExists(const std::string& itemId) const;
@@ -59,6 +122,7 @@ public:
     };
     bool FetchGameModes();
     const std::vector<GameMode>& GetGameModes() const;
+    const SearchIndex& GetGameModeSearchIndex() const;
     struct SummonerSpell {
         std::string id;
         std::string name;
@@ -66,47 +130,123 @@ public:
         std::vector<std::string> modes;
         std::string cooldownBurn;
         int summonerLevel;
+        Sprite sprite;
     };
     bool FetchSummonerSpells();
     const std::vector<SummonerSpell>& GetSummonerSpells() const;
     std::vector<SummonerSpell> GetSummonerSpellsForMode(const std::string& mode) const;
 
+    // Name search shared by the GUI and headless queries
+    struct NameMatch {
+        enum class Kind { Champion, Item, SummonerSpell };
+        Kind kind;
+        uint32_t index;             // into GetChampionNames(), GetItemNames() or GetSummonerSpells()
+        uint32_t distance;          // 0 for an exact substring match
+        std::string name;
+    };
+    std::vector<NameMatch> SearchNames(const std::string& query, size_t limit = 20) const;
+
+    // Full-text search over lore, abilities, tips and descriptions
+    struct TextMatch {
+        enum class Field { Lore, Passive, Spell, AllyTip, EnemyTip, ItemDescription, SummonerSpellDescription };
+        Field field;
+        std::string title;          // champion, item or summoner spell name, plus the ability name
+        std::string text;
+        float score;
+    };
+    std::vector<TextMatch> SearchText(const std::string& query, size_t limit = 20) const;
+
 
 
 private:
     /**
-     * @brief HTTP client for fetching champion data
+     * @brief Pooled connections shared with GUIManager, declared before the cache that uses it
+     */
+    mutable HttpTransport httpTransport;
+    /**
+     * @brief Disk cache every fetch goes through
      */
-    mutable httplib::Client client;
+    mutable HttpCache httpCache;
+    bool Download(const std::string& url, std::string& body, const HttpTransport::DataCallback& onData = nullptr,
+                  HttpTransport::Priority priority = HttpTransport::Priority::Visible) const;
 
     std::string defaultLanguage;
+    std::string patchVersion;
+    std::vector<std::string> languages;
+    std::vector<StageTiming> startupTimings;
+
     /**
-     * champion.json
+     * @brief Memory-mapped champion / item / summoner spell records, see Snapshot.h
      */
-    nlohmann::json championData;
+    Snapshot snapshot;
+    SnapshotBuilder snapshotBuilder;
+    std::filesystem::path snapshotPath;
+
+    bool ResolvePatchVersion();
+    bool LoadSnapshot(bool patchResolved);
+    bool RebuildSnapshot();
+    void ProcessSnapshot();
+    bool ParseLanguageData(const std::string& body);
+    bool ParseSummonerSpellData(const std::string& body);
     /**
-     * Specific champion data for each champion
+     * Champion records in snapshot order, parallel to championNames.
+     * Details are published once per champion through championDetails and read without locking.
      */
-    mutable std::map<std::string, nlohmann::json> specificChampionData;  // Now mutable
+    std::vector<ChampionRecord> championRecords;
+    mutable std::vector<std::atomic<const ChampionDetails*>> championDetails;
+    mutable std::vector<std::unique_ptr<const ChampionDetails>> championDetailStore;
+    mutable std::mutex championDetailStoreMutex;
+    /**
+     * Champions the GUI asked for before their details arrived, see GetChampionDetails.
+     * Requested ones wait in urgentChampionDetails for the prefetch workers, or get a
+     * one-off fetch in championDetailFetches when no prefetch is running. A failed
+     * champion is not asked for again until its retryAt.
+     */
+    struct ChampionDetailRequest {
+        bool requested = false;
+        std::chrono::steady_clock::time_point retryAt;
+    };
+    mutable std::mutex championRequestMutex;
+    mutable std::vector<ChampionDetailRequest> championDetailRequests;
+    mutable std::deque<size_t> urgentChampionDetails;
+    mutable bool championPrefetchRunning = false;
+    mutable std::vector<std::future<void>> championDetailFetches;
+    void RequestChampionDetails(size_t index) const;
+    void StartChampionDetailFetch(size_t index) const;
+    bool FetchChampionDetails(size_t index, HttpTransport::Priority priority) const;
+    size_t FindChampionIndex(const std::string& championId) const;
+    bool ParseSpecificChampionData(const std::string& championId, const std::string& body) const;
     std::vector<std::string> championNames;
     std::map<std::string, std::string> championNameToIdMap;
+    SearchIndex championSearchIndex;
 
+    bool ParseChampionData(const std::string& body);
     void ProcessChampionData();
 
     /**
-     * @brief HTTP client for fetching item data
+     * @brief Item columns built from the snapshot; itemNames follows the same handle order
      */
-    mutable httplib::Client itemClient;
-
-    mutable nlohmann::json itemData;
-    mutable std::map<std::string, nlohmann::json> specificItemData;
-    mutable std::vector<std::string> itemNames;
-    mutable std::map<std::string, std::string> itemNameToIdMap;
+    ItemStore itemStore;
+    std::vector<std::string> itemNames;
+    SearchIndex itemSearchIndex;
     const std::set<std::string> validTags = { "FIGHTER", "ASSASSIN", "MARKSMAN", "MAGE", "TANK", "SUPPORT" };
+    uint64_t validTagMask = 0;
 
+    StageTiming StreamItemData();
     void ProcessItemData();
 
     // Summoner spell window related
     std::vector<GameMode> gameModes;
+    SearchIndex gameModeSearchIndex;
     std::vector<SummonerSpell> summonerSpells;
+    SearchIndex summonerSpellSearchIndex;
+    void IndexSummonerSpells();
+
+    /**
+     * @brief Full-text index, loaded from textIndexPath or built on the first SearchText call
+     */
+    mutable TextIndex textIndex;
+    mutable std::once_flag textIndexOnce;
+    std::filesystem::path textIndexPath;
+    void PrepareTextIndex() const;
 };
\ No newline at end of file
@@ -5,8 +5,8 @@
 #define STB_IMAGE_IMPLEMENTATION
 // #include "stb_image.h"
 #include <stb_image.h>
-#include <curl/curl.h>
 #include <GLFW/glfw3.h>
+#define NOMINMAX  // glfw3native.h and Windows.h would turn std::min / std::max into macros
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 #include <Windows.h>
@@ -21,15 +21,17 @@ static void glfw_error_callback(int error, const char *description)
 GUIManager::GUIManager()
     : window(nullptr),
       backgroundTexture(0),
-      championSplashTexture(0),
       windowOffset(10.0f),
       currentState(WindowState::Default),
+      textureLoader(dataManager.GetHttpTransport(), std::filesystem::current_path() / "cache" / "images"),
+      textureCache(textureLoader),
       selectedChampionIndex(-1),
       isChampionSplashLoaded(false),
       iconTexture(0),
       isIconLoaded(false),
       skillTextures(5, 0),
       areSkillIconsLoaded(false),
+      rng(std::random_device{}()),
       isRandomizing(false),
       hasRandomChampion(false),
       comboSelectedIndex(-1),
@@ -136,23 +138,18 @@ bool GUIManager::Initialize( int width, int height, const char* title )
     // backgroundTexture = LoadTexture(".\\assets\\image.png");
     backgroundTexture = this->LoadTexture( ".\\data\\image.png" );
 
-    if ( !dataManager.FetchLanguageData())
+    // languages, champion and item data are fetched concurrently
+    if ( !dataManager.FetchStartupData() )
     {
-        std::cerr << "Failed to fetch language data" << std::endl;
+        std::cerr << "Failed to fetch startup data" << std::endl;
         return false;
     }
 
-    if ( !dataManager.FetchChampionData() )
+    // champion detail files are fetched in the background so selecting a champion is a lookup
+    championPrefetchFuture = std::async( std::launch::async, [this]()
     {
-        std::cerr << "Failed to fetch champion data" << std::endl;
-        return false;
-    }
-
-    if ( !dataManager.FetchItemData() )
-    {
-        std::cerr << "Failed to fetch item data" << std::endl;
-        return false;
-    }
+        return dataManager.PrefetchChampionDetails();
+    } );
 
     InitializeHistory();
 
@@ -184,6 +181,10 @@ void GUIManager::Render()
 {
     glfwPollEvents();
 
+    // images decoded by the loader's workers since the last frame, within the frame budget
+    textureLoader.Upload();
+    textureCache.NextFrame();
+
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -216,6 +217,24 @@ void GUIManager::Cleanup()
             glDeleteTextures(1, &texture);
         }
     }
+    for (auto &pair : spriteSheets)
+    {
+        textureLoader.Release(pair.second);
+    }
+    spriteSheets.clear();
+    TextureLoader::Stats loaderStats = textureLoader.GetStats();
+    std::cout << "[texture] " << loaderStats.requested << " requested, " << loaderStats.cacheHits << " from the image cache in "
+              << loaderStats.cacheLoadMs << " ms, decoded in " << loaderStats.decodeMs << " ms, "
+              << loaderStats.prefetched << " prefetched (" << loaderStats.prefetchesDropped << " dropped), "
+              << loaderStats.coalesced << " coalesced, " << loaderStats.cancelled << " cancelled" << std::endl;
+    std::cout << "[texture] " << loaderStats.uploaded << " uploaded, " << loaderStats.uploadedBytes / 1024 << " KiB ("
+              << loaderStats.stagedBytes / 1024 << " KiB staged by the workers), worst frame " << loaderStats.worstFrameMs << " ms"
+              << std::endl;
+    HttpTransport::Stats httpStats = dataManager.GetHttpTransport().GetStats();
+    std::cout << "[http] " << httpStats.requests << " requests, " << httpStats.coalesced << " coalesced, " << httpStats.cancelled
+              << " cancelled, " << httpStats.preempted << " preempted" << std::endl;
+    textureCache.Clear();
+    textureLoader.GetAtlas().Clear();
     glfwDestroyWindow(window);
     glfwTerminate();
 }
@@ -499,18 +518,12 @@ void GUIManager::RenderDefaultWindow()
 void GUIManager::RenderChampionsWindow()
 {
     const auto &championNames = dataManager.GetChampionNames();
+    hoveredChampion = -1;
 
     // Display champion splash art as background if a champion is selected
     if (isChampionSplashLoaded && selectedChampionIndex >= 0)
     {
-        ImGui::GetWindowDrawList()->AddImage(
-            //(void*)(intptr_t)championSplashTexture,
-            (ImTextureID)(intptr_t)championSplashTexture,
-            ImGui::GetWindowPos(),
-            ImVec2(ImGui::GetWindowPos().x + ImGui::GetWindowSize().x, ImGui::GetWindowPos().y + ImGui::GetWindowSize().y),
-            ImVec2(0, 0), ImVec2(1, 1),
-            IM_COL32(255, 255, 255, 128) // 50% opacity
-        );
+        RenderChampionSplash();
     }
 
     // Create a semi-transparent overlay for the controls
@@ -540,50 +553,56 @@ void GUIManager::RenderChampionsWindow()
         // Add a search input field at the top of the combo box
         ImGui::PushItemWidth(-1);
         ImGui::SetCursorPos(ImVec2(10, 10));
-        if (ImGui::InputText("##Search", searchBuffer, IM_ARRAYSIZE(searchBuffer)))
-        {
-            // Convert search to lowercase for case-insensitive comparison
-            std::string search = searchBuffer;
-            std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-        }
+        ImGui::InputText("##Search", searchBuffer, IM_ARRAYSIZE(searchBuffer));
         ImGui::PopItemWidth();
         ImGui::Separator();
 
-        for (int i = 0; i < championNames.size(); i++)
+        // Only display champions that match the search; the index re-filters only when the text changes
+        const std::vector<uint32_t> &matches = championSearch.Update(dataManager.GetChampionSearchIndex(), searchBuffer);
+        for (size_t position = 0; position < matches.size(); ++position)
         {
-            // Convert champion name to lowercase for case-insensitive comparison
-            std::string lowerChampName = championNames[i];
-            std::transform(lowerChampName.begin(), lowerChampName.end(), lowerChampName.begin(), ::tolower);
-
-            // Only display champions that match the search
-            if (lowerChampName.find(searchBuffer) != std::string::npos)
+            int i = static_cast<int>(matches[position]);
+            bool is_selected = (selectedChampionIndex == i);
+            ImVec2 rowSize(0, 0);
+            const DataManager::Sprite &sprite = dataManager.GetChampionRecords()[i].sprite;
+            if (useSpriteSheets && sprite.IsValid())
             {
-                bool is_selected = (selectedChampionIndex == i);
-                if (ImGui::Selectable(championNames[i].c_str(), is_selected))
-                {
-                    if (selectedChampionIndex != i)
-                    { // Check if a different champion is selected
-                        selectedChampionIndex = i;
-                        std::string championId = dataManager.GetChampionId(championNames[i]);
-                        LoadChampionSplash(championId);
-                        LoadChampionIcon(championId);
-                        areSkillIconsLoaded = false;
-                        selectedSkill = "";    // Reset selected skill when changing champion
-                        skillDescription = ""; // Clear skill description
-                        // Reset tip-related states
-                        showAllyTip = false;
-                        showEnemyTip = false;
-                        allyTips.clear();
-                        enemyTips.clear();
-                        allyTipIndices.clear();
-                        enemyTipIndices.clear();
-                        currentAllyTipIndex = 0;
-                        currentEnemyTipIndex = 0;
-                    }
+                // roster icons all come from the few champion sheets, never one request per champion
+                TextureAtlas::Region region = SpriteRegion(sprite);
+                ImGui::Image((ImTextureID)(intptr_t)region.texture, ImVec2(24, 24), ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
+                ImGui::SameLine();
+                rowSize.y = 24;
+            }
+            if (ImGui::Selectable(championNames[i].c_str(), is_selected, 0, rowSize))
+            {
+                if (selectedChampionIndex != i)
+                { // Check if a different champion is selected
+                    selectedChampionIndex = i;
+                    std::string championId = dataManager.GetChampionId(championNames[i]);
+                    LoadChampionSplash(championId);
+                    LoadChampionIcon(championId);
+                    areSkillIconsLoaded = false;
+                    selectedSkill = "";    // Reset selected skill when changing champion
+                    skillDescription = ""; // Clear skill description
+                    // Reset tip-related states
+                    showAllyTip = false;
+                    showEnemyTip = false;
+                    allyTips.clear();
+                    enemyTips.clear();
+                    allyTipIndices.clear();
+                    enemyTipIndices.clear();
+                    currentAllyTipIndex = 0;
+                    currentEnemyTipIndex = 0;
                 }
-                if (is_selected)
-                    ImGui::SetItemDefaultFocus();
             }
+            if (ImGui::IsItemHovered())
+            {
+                hoveredChampion = i;
+                hoveredNeighbours[0] = position > 0 ? static_cast<int>(matches[position - 1]) : -1;
+                hoveredNeighbours[1] = position + 1 < matches.size() ? static_cast<int>(matches[position + 1]) : -1;
+            }
+            if (is_selected)
+                ImGui::SetItemDefaultFocus();
         }
         ImGui::EndCombo();
     }
@@ -628,23 +647,25 @@ void GUIManager::RenderChampionsWindow()
     // Display champion splash art as background
     if (isChampionSplashLoaded && selectedChampionIndex >= 0)
     {
-        ImGui::GetWindowDrawList()->AddImage(
-            //(void*)(intptr_t)championSplashTexture,
-            (ImTextureID)(intptr_t)championSplashTexture,
-            ImGui::GetWindowPos(),
-            ImVec2(ImGui::GetWindowPos().x + ImGui::GetWindowSize().x, ImGui::GetWindowPos().y + ImGui::GetWindowSize().y),
-            ImVec2(0, 0), ImVec2(1, 1),
-            IM_COL32(255, 255, 255, 128) // 50% opacity
-        );
+        RenderChampionSplash();
     }
 
     if (selectedChampionIndex >= 0)
     {
-        std::string championName = championNames[selectedChampionIndex];
-        std::string championId = dataManager.GetChampionId(championName);
+        // typed records, no copies or json lookups per frame
+        const DataManager::ChampionRecord &champion = dataManager.GetChampionRecords()[selectedChampionIndex];
+        const DataManager::ChampionDetails *details = dataManager.GetChampionDetails(champion);
+        const std::string &championName = champion.name;
+        const std::string &championId = champion.id;
 
         // Display champion icon
-        if (isChampionIconLoaded)
+        if (useSpriteSheets && champion.sprite.IsValid())
+        {
+            TextureAtlas::Region region = SpriteRegion(champion.sprite);
+            ImGui::SetCursorPos(ImVec2(10, 50));
+            ImGui::Image((ImTextureID)(intptr_t)region.texture, ImVec2(64, 64), ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
+        }
+        else if (isChampionIconLoaded)
         {
             ImGui::SetCursorPos(ImVec2(10, 50));
             // ImGui::Image((void*)(intptr_t)championIconTexture, ImVec2(64, 64));
@@ -655,28 +676,24 @@ void GUIManager::RenderChampionsWindow()
         ImGui::SetCursorPos(ImVec2(10, 120));
         ImGui::BeginChild("ChampionInfo", ImVec2(300, 500), true, ImGuiWindowFlags_NoScrollbar);
 
-        nlohmann::json stats = dataManager.GetChampionStats(championName);
-        std::string title = dataManager.GetChampionTitle(championName);
-        std::string lore = dataManager.GetChampionLore(championName);
-        auto tags = dataManager.GetChampionTags(championName);
         ImGui::Indent(5.0f);
         ImGui::Text("Champion: %s", championName.c_str());
-        ImGui::Text("Title: %s", title.c_str());
+        ImGui::Text("Title: %s", champion.title.c_str());
         ImGui::Text("Tags: ");
-        for (const auto &tag : tags)
+        for (const auto &tag : champion.tags)
         {
             ImGui::SameLine();
             ImGui::Text("%s", tag.c_str());
         }
         ImGui::Text("Base Stats:");
-        ImGui::Text("HP: %.0f (+ %.0f per level)", stats["hp"].get<float>(), stats["hpperlevel"].get<float>());
-        ImGui::Text("Armor: %.1f (+ %.2f per level)", stats["armor"].get<float>(), stats["armorperlevel"].get<float>());
-        ImGui::Text("Magic Resist: %.1f (+ %.2f per level)", stats["spellblock"].get<float>(), stats["spellblockperlevel"].get<float>());
-        ImGui::Text("Move Speed: %.0f", stats["movespeed"].get<float>());
-        ImGui::Text("Attack Damage: %.0f (+ %.0f per level)", stats["attackdamage"].get<float>(), stats["attackdamageperlevel"].get<float>());
-        ImGui::Text("Attack Speed: %.3f (+ %.1f%% per level)", stats["attackspeed"].get<float>(), stats["attackspeedperlevel"].get<float>());
-        ImGui::Text("Attack Range: %.0f", stats["attackrange"].get<float>());
-        ImGui::Text("HP Regen: %.1f (+ %.1f per level)", stats["hpregen"].get<float>(), stats["hpregenperlevel"].get<float>());
+        ImGui::Text("HP: %.0f (+ %.0f per level)", champion.Stat(ChampionStat::Hp), champion.Stat(ChampionStat::HpPerLevel));
+        ImGui::Text("Armor: %.1f (+ %.2f per level)", champion.Stat(ChampionStat::Armor), champion.Stat(ChampionStat::ArmorPerLevel));
+        ImGui::Text("Magic Resist: %.1f (+ %.2f per level)", champion.Stat(ChampionStat::SpellBlock), champion.Stat(ChampionStat::SpellBlockPerLevel));
+        ImGui::Text("Move Speed: %.0f", champion.Stat(ChampionStat::MoveSpeed));
+        ImGui::Text("Attack Damage: %.0f (+ %.0f per level)", champion.Stat(ChampionStat::AttackDamage), champion.Stat(ChampionStat::AttackDamagePerLevel));
+        ImGui::Text("Attack Speed: %.3f (+ %.1f%% per level)", champion.Stat(ChampionStat::AttackSpeed), champion.Stat(ChampionStat::AttackSpeedPerLevel));
+        ImGui::Text("Attack Range: %.0f", champion.Stat(ChampionStat::AttackRange));
+        ImGui::Text("HP Regen: %.1f (+ %.1f per level)", champion.Stat(ChampionStat::HpRegen), champion.Stat(ChampionStat::HpRegenPerLevel));
         ImGui::Unindent(5.0f);
         ImGui::EndChild();
 
@@ -685,14 +702,14 @@ void GUIManager::RenderChampionsWindow()
         ImGui::BeginChild("ChampionLore", ImVec2(ImGui::GetWindowWidth() - 330, 100), true, ImGuiWindowFlags_HorizontalScrollbar);
 
         ImGui::Indent(5.0f);
-        ImGui::TextWrapped("%s", lore.c_str());
+        ImGui::TextWrapped("%s", details ? details->lore.c_str() : "");
         ImGui::Unindent(5.0f);
         ImGui::EndChild();
 
         // Load and display skill icons
-        if (!areSkillIconsLoaded)
+        if (!areSkillIconsLoaded && details)
         {
-            LoadSkillIcons(championId);
+            LoadSkillIcons(championId, *details);
         }
 
         // Display skill icons and buttons
@@ -709,7 +726,17 @@ void GUIManager::RenderChampionsWindow()
                 ImGui::SameLine(0, spacing);
 
             ImGui::BeginGroup();
-            if (skillTextures[i] != 0)
+            const DataManager::ChampionAbility *ability = nullptr;
+            if (details)
+            {
+                ability = i == 0 ? &details->passive : i - 1 < static_cast<int>(details->spells.size()) ? &details->spells[i - 1] : nullptr;
+            }
+            if (useSpriteSheets && ability && ability->sprite.IsValid())
+            {
+                TextureAtlas::Region region = SpriteRegion(ability->sprite);
+                ImGui::Image((ImTextureID)(intptr_t)region.texture, ImVec2(iconSize, iconSize), ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
+            }
+            else if (skillTextures[i] != 0)
             {
                 // ImGui::Image((void*)(intptr_t)skillTextures[i], ImVec2(iconSize, iconSize));
                 ImGui::Image((ImTextureID)(intptr_t)skillTextures[i], ImVec2(iconSize, iconSize));
@@ -768,27 +795,29 @@ void GUIManager::RenderChampionsWindow()
         }
 
         // Display skins if showSkins is true
-        if (showSkins)
+        if (showSkins && details)
         {
-            auto skins = dataManager.GetChampionSkins(championName);
+            const auto &skins = details->skins;
             if (!skins.empty())
             {
                 const auto &currentSkin = skins[currentSkinIndex];
-                std::string skinName = currentSkin["name"];
-                std::string skinNum = std::to_string(currentSkin["num"].get<int>());
-                std::string skinKey = championId + "_" + skinNum;
+                const std::string &skinName = currentSkin.name;
 
-                // Load skin texture if not already loaded
-                if (skinTextures.find(skinKey) == skinTextures.end())
+                // Loaded on first view at the size it is shown at, evicted again once the cache is over budget and the skin is out of view
+                if (skinCancelIndex != currentSkinIndex)
                 {
-                    std::string skinImageUrl = dataManager.GetChampionSkinImageUrl(championId, skinNum);
-                    skinTextures[skinKey] = LoadSkinTexture(skinImageUrl);
+                    skinCancel.Cancel();  // flipped past before it loaded
+                    skinCancel = HttpTransport::CancelToken::Create();
+                    skinCancelIndex = currentSkinIndex;
                 }
+                const ImVec2 skinSize(240, 136);
+                GLuint skinTexture = textureCache.Get(dataManager.GetChampionSkinImageUrl(championId, currentSkin.num),
+                                                      static_cast<int>(skinSize.x), static_cast<int>(skinSize.y), skinCancel);
 
                 // Display skin image
                 ImGui::SetCursorPos(ImVec2(390, 440)); // Adjust position as needed
                 // ImGui::Image((void*)(intptr_t)skinTextures[skinKey], ImVec2(240, 136)); // Adjust size as needed
-                ImGui::Image((ImTextureID)(intptr_t)skinTextures[skinKey], ImVec2(240, 136)); // Adjust size as needed
+                ImGui::Image((ImTextureID)(intptr_t)skinTexture, skinSize); // Adjust size as needed
 
                 // Display skin name in a chat box style
                 ImGui::SetCursorPos(ImVec2(390, 580)); // Adjusted position
@@ -825,9 +854,9 @@ void GUIManager::RenderChampionsWindow()
         if (ImGui::Button("Ally Tips"))
         {
             showAllyTip = !showAllyTip;
-            if (showAllyTip && allyTips.empty())
+            if (showAllyTip && allyTips.empty() && details)
             {
-                allyTips = dataManager.GetChampionAllyTips(championName);
+                allyTips = details->allyTips;
                 if (!allyTips.empty())
                 {
                     RandomizeTips(allyTips, allyTipIndices);
@@ -868,9 +897,9 @@ void GUIManager::RenderChampionsWindow()
         if (ImGui::Button("Enemy Tips"))
         {
             showEnemyTip = !showEnemyTip;
-            if (showEnemyTip && enemyTips.empty())
+            if (showEnemyTip && enemyTips.empty() && details)
             {
-                enemyTips = dataManager.GetChampionEnemyTips(championName);
+                enemyTips = details->enemyTips;
                 if (!enemyTips.empty())
                 {
                     RandomizeTips(enemyTips, enemyTipIndices);
@@ -906,106 +935,186 @@ void GUIManager::RenderChampionsWindow()
             ImGui::EndChild();
         }
     }
+
+    UpdatePrefetch();
 }
 
-void GUIManager::CleanupSkinTextures()
+/**
+ * Splash size for the window it fills, rounded up to 256 pixels so resizing the window rarely reloads it.
+ */
+static void SplashTargetSize(const ImVec2 &windowSize, int &width, int &height)
 {
-    for (auto &pair : skinTextures)
-    {
-        glDeleteTextures(1, &pair.second);
-    }
-    skinTextures.clear();
+    width = (static_cast<int>(windowSize.x) + 255) / 256 * 256;
+    height = (static_cast<int>(windowSize.y) + 255) / 256 * 256;
 }
 
-void GUIManager::LoadChampionSplash(const std::string &championName)
+/**
+ * Prefetches what is likely to be shown next: the hovered champion, the skins either side of the one shown, the champion
+ * the next Random Champion press picks, and the hovered champion's neighbours in the list. The list is only rebuilt when
+ * one of those changes, which drops the prefetches a worker has not started yet.
+ */
+void GUIManager::UpdatePrefetch()
 {
-    CURL *curl = curl_easy_init();
-    if (curl)
+    int skin = showSkins && selectedChampionIndex >= 0 ? static_cast<int>(currentSkinIndex) : -1;
+    int nextRandom = nextRandomChampion.load();
+    if (nextRandom < 0 && !dataManager.GetChampionRecords().empty())
     {
-        std::string url = dataManager.GetChampionImageUrl(championName);
-        std::string imageData;
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &imageData);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+        nextRandom = PickRandomChampion(selectedChampionIndex);
+        nextRandomChampion.store(nextRandom);
+    }
+    int state[] = {selectedChampionIndex, hoveredChampion, hoveredNeighbours[0], hoveredNeighbours[1], skin, nextRandom};
+    if (std::equal(std::begin(state), std::end(state), std::begin(prefetchState)))
+    {
+        return;
+    }
+    std::copy(std::begin(state), std::end(state), std::begin(prefetchState));
 
-        if (res == CURLE_OK)
+    const auto &records = dataManager.GetChampionRecords();
+    int splashWidth = 0, splashHeight = 0;
+    SplashTargetSize(ImGui::GetWindowSize(), splashWidth, splashHeight);
+    std::vector<TextureLoader::PrefetchItem> items;
+    auto addChampion = [&](int index, HttpTransport::Priority priority)
+    {
+        if (index < 0 || index == selectedChampionIndex || index >= static_cast<int>(records.size()))
+        {
+            return;
+        }
+        const std::string &championId = records[index].id;
+        items.push_back({dataManager.GetChampionTileUrl(championId), 96, 96, priority});
+        items.push_back({dataManager.GetChampionImageUrl(championId), splashWidth, splashHeight, priority});
+        if (!useSpriteSheets)
         {
-            int width, height, channels;
-            unsigned char *image = stbi_load_from_memory(
-                reinterpret_cast<const unsigned char *>(imageData.data()),
-                imageData.size(), &width, &height, &channels, 4);
+            items.push_back({dataManager.GetChampionIconUrl(championId), 0, 0, priority});
+        }
+    };
 
-            if (image)
+    // under the mouse and one click away download ahead of the rest
+    addChampion(hoveredChampion, HttpTransport::Priority::NearVisible);
+    if (skin >= 0)
+    {
+        // details of the selected champion are loaded, it is on screen
+        const DataManager::ChampionDetails *details = dataManager.GetChampionDetails(records[selectedChampionIndex]);
+        for (int adjacent : {skin + 1, skin - 1})
+        {
+            if (details && adjacent >= 0 && adjacent < static_cast<int>(details->skins.size()))
             {
-                if (isChampionSplashLoaded)
-                {
-                    glDeleteTextures(1, &championSplashTexture);
-                }
-
-                glGenTextures(1, &championSplashTexture);
-                glBindTexture(GL_TEXTURE_2D, championSplashTexture);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-
-                stbi_image_free(image);
-                isChampionSplashLoaded = true;
+                items.push_back({dataManager.GetChampionSkinImageUrl(records[selectedChampionIndex].id, details->skins[adjacent].num), 240, 136,
+                                 HttpTransport::Priority::NearVisible});
             }
         }
     }
+    addChampion(nextRandom, HttpTransport::Priority::Prefetch);
+    addChampion(hoveredNeighbours[0], HttpTransport::Priority::Prefetch);
+    addChampion(hoveredNeighbours[1], HttpTransport::Priority::Prefetch);
+    textureLoader.Prefetch(items);
 }
 
-void GUIManager::LoadChampionIcon(const std::string &championName)
+int GUIManager::PickRandomChampion(int exclude)
 {
-    // Similar to LoadChampionSplash, but for the icon
-    CURL *curl = curl_easy_init();
-    if (curl)
+    int count = static_cast<int>(dataManager.GetChampionRecords().size());
+    if (count < 2)
     {
-        std::string url = dataManager.GetChampionIconUrl(championName); // You'll need to add this function to DataManager
-        std::string imageData;
+        return 0;
+    }
+    if (exclude < 0 || exclude >= count)
+    {
+        return std::uniform_int_distribution<int>(0, count - 1)(rng);  // nothing selected yet, every champion is a choice
+    }
+    // one fewer choice, with the excluded index mapped to the last one
+    int pick = std::uniform_int_distribution<int>(0, count - 2)(rng);
+    return pick == exclude ? count - 1 : pick;
+}
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &imageData);
+void GUIManager::LoadChampionSplash(const std::string &championName)
+{
+    // requested from the cache when drawn, transparent until the worker has fetched and decoded the image
+    championSplashUrl = dataManager.GetChampionImageUrl(championName);
+    championTileUrl = dataManager.GetChampionTileUrl(championName);
+    // loads of the previous champion still in flight are dropped, their transfers aborted
+    championCancel.Cancel();
+    championCancel = HttpTransport::CancelToken::Create();
+    skinCancel.Cancel();
+    skinCancelIndex = SIZE_MAX;
+    championSplashFrame = -1;
+    championSplashReadyTime = -1.0;
+    isChampionSplashLoaded = true;
+}
 
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+/**
+ * Draws the splash over the window at 50% opacity. Until it is loaded the champion's tile stands in, decoded
+ * at a thumbnail size so it shows up one small download after a switch, then the splash fades in over it.
+ */
+void GUIManager::RenderChampionSplash()
+{
+    const float kFadeSeconds = 0.25f;
+    ImVec2 min = ImGui::GetWindowPos();
+    ImVec2 size = ImGui::GetWindowSize();
+    ImVec2 max(min.x + size.x, min.y + size.y);
+    if (championSplashFrame < 0)
+    {
+        championSplashFrame = ImGui::GetFrameCount();
+    }
 
-        if (res == CURLE_OK)
+    int width = 0, height = 0;
+    SplashTargetSize(size, width, height);
+    GLuint splash = textureCache.Get(championSplashUrl, width, height, championCancel);
+    float fade = 0.0f;
+    if (textureLoader.IsReady(splash))
+    {
+        double now = ImGui::GetTime();
+        if (championSplashReadyTime < 0.0)
         {
-            int width, height, channels;
-            unsigned char *image = stbi_load_from_memory(
-                reinterpret_cast<const unsigned char *>(imageData.data()),
-                imageData.size(), &width, &height, &channels, 4);
-
-            if (image)
-            {
-                if (isChampionIconLoaded)
-                {
-                    glDeleteTextures(1, &championIconTexture);
-                }
-
-                glGenTextures(1, &championIconTexture);
-                glBindTexture(GL_TEXTURE_2D, championIconTexture);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+            // already resident when the champion was picked, nothing to fade from
+            championSplashReadyTime = ImGui::GetFrameCount() == championSplashFrame ? now - kFadeSeconds : now;
+        }
+        fade = std::min(1.0f, static_cast<float>(now - championSplashReadyTime) / kFadeSeconds);
+    }
 
-                stbi_image_free(image);
-                isChampionIconLoaded = true;
-            }
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    if (fade < 1.0f)
+    {
+        // the tile is a square crop around the champion, cut down to the window's aspect
+        GLuint tile = textureCache.Get(championTileUrl, 96, 96, championCancel);
+        float aspect = size.y > 0.0f ? size.x / size.y : 1.0f;
+        ImVec2 uv0(0.0f, 0.0f), uv1(1.0f, 1.0f);
+        if (aspect >= 1.0f)
+        {
+            uv0.y = 0.5f - 0.5f / aspect;
+            uv1.y = 0.5f + 0.5f / aspect;
         }
+        else
+        {
+            uv0.x = 0.5f - 0.5f * aspect;
+            uv1.x = 0.5f + 0.5f * aspect;
+        }
+        drawList->AddImage((ImTextureID)(intptr_t)tile, min, max, uv0, uv1, IM_COL32(255, 255, 255, static_cast<int>(128 * (1.0f - fade))));
+    }
+    if (fade > 0.0f)
+    {
+        drawList->AddImage((ImTextureID)(intptr_t)splash, min, max, ImVec2(0, 0), ImVec2(1, 1),
+                           IM_COL32(255, 255, 255, static_cast<int>(128 * fade))); // 50% opacity
     }
 }
 
-size_t GUIManager::WriteCallback(void *contents, size_t size, size_t nmemb, void *userp)
+void GUIManager::LoadChampionIcon(const std::string &championName)
 {
-    ((std::string *)userp)->append((char *)contents, size * nmemb);
-    return size * nmemb;
+    if (isChampionIconLoaded)
+    {
+        textureLoader.Release(championIconTexture);
+        isChampionIconLoaded = false;
+    }
+
+    if (useSpriteSheets)
+    {
+        const auto &records = dataManager.GetChampionRecords();
+        auto record = std::find_if(records.begin(), records.end(), [&championName](const DataManager::ChampionRecord &record) { return record.id == championName; });
+        if (record != records.end() && record->sprite.IsValid())
+        {
+            return;  // drawn from its sprite sheet
+        }
+    }
+    championIconTexture = textureLoader.Request(dataManager.GetChampionIconUrl(championName));
+    isChampionIconLoaded = true;
 }
 
 /**
@@ -1040,113 +1149,44 @@ bool GUIManager::LoadIconTexture( const char* filename )
     return true;
 }
 
-void GUIManager::LoadSkillIcons(const std::string &championId)
+void GUIManager::LoadSkillIcons(const std::string &championId, const DataManager::ChampionDetails &details)
 {
-    auto spells = dataManager.GetChampionSpells(championId);
-    auto passive = dataManager.GetChampionPassive(championId);
+    const auto &spells = details.spells;
+    const auto &passive = details.passive;
 
     // Load passive icon and description
-    LoadSkillIcon(passive["image"]["full"], 0);
-    skillDescriptions["Passive"] = passive["name"].get<std::string>() + ": " + passive["description"].get<std::string>();
+    LoadSkillIcon(passive, 0);
+    skillDescriptions["Passive"] = passive.name + ": " + passive.description;
 
     // Load skill icons and descriptions
     std::string skillNames[] = {"Q", "W", "E", "R"};
     for (int i = 0; i < spells.size() && i < 4; ++i)
     {
-        LoadSkillIcon(spells[i]["image"]["full"], i + 1);
-        skillDescriptions[championId + " " + skillNames[i]] =
-            spells[i]["name"].get<std::string>() + ": " + spells[i]["description"].get<std::string>();
+        LoadSkillIcon(spells[i], i + 1);
+        skillDescriptions[championId + " " + skillNames[i]] = spells[i].name + ": " + spells[i].description;
     }
 
     areSkillIconsLoaded = true;
 }
 
-void GUIManager::LoadSkillIcon(const std::string &iconFilename, int index)
+void GUIManager::LoadSkillIcon(const DataManager::ChampionAbility &ability, int index)
 {
-    CURL *curl = curl_easy_init();
-    if (curl)
+    std::string url = "http://ddragon.leagueoflegends.com/cdn/" + dataManager.GetPatchVersion() + "/img/passive/" + ability.image;
+    if (index > 0)
     {
-        std::string url = "http://ddragon.leagueoflegends.com/cdn/14.14.1/img/passive/" + iconFilename;
-        if (index > 0)
-        {
-            url = "http://ddragon.leagueoflegends.com/cdn/14.14.1/img/spell/" + iconFilename;
-        }
-        std::string imageData;
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &imageData);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-
-        if (res == CURLE_OK)
-        {
-            int width, height, channels;
-            unsigned char *image = stbi_load_from_memory(
-                reinterpret_cast<const unsigned char *>(imageData.data()),
-                imageData.size(), &width, &height, &channels, 4);
-
-            if (image)
-            {
-                if (skillTextures[index] != 0)
-                {
-                    glDeleteTextures(1, &skillTextures[index]);
-                }
-
-                glGenTextures(1, &skillTextures[index]);
-                glBindTexture(GL_TEXTURE_2D, skillTextures[index]);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-
-                stbi_image_free(image);
-            }
-        }
+        url = "http://ddragon.leagueoflegends.com/cdn/" + dataManager.GetPatchVersion() + "/img/spell/" + ability.image;
     }
-}
 
-GLuint GUIManager::LoadSkinTexture(const std::string &url)
-{
-    CURL *curl = curl_easy_init();
-    GLuint texture = 0;
-    if (curl)
+    if (skillTextures[index] != 0)
     {
-        std::string imageData;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &imageData);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-
-        if (res == CURLE_OK)
-        {
-            int width, height, channels;
-            unsigned char *image = stbi_load_from_memory(
-                reinterpret_cast<const unsigned char *>(imageData.data()),
-                imageData.size(), &width, &height, &channels, 4);
-
-            if (image)
-            {
-                glGenTextures(1, &texture);
-                glBindTexture(GL_TEXTURE_2D, texture);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-                stbi_image_free(image);
-            }
-            else
-            {
-                std::cerr << "Failed to load skin image: " << url << std::endl;
-            }
-        }
-        else
-        {
-            std::cerr << "Failed to download skin image: " << url << std::endl;
-        }
+        textureLoader.Release(skillTextures[index]);
+        skillTextures[index] = 0;
     }
-    return texture;
+    if (useSpriteSheets && ability.sprite.IsValid())
+    {
+        return;  // drawn from its sprite sheet
+    }
+    skillTextures[index] = textureLoader.Request(url);
 }
 
 void GUIManager::RandomizeTips(const std::vector<std::string> &tips, std::vector<size_t> &indices)
@@ -1167,23 +1207,26 @@ void GUIManager::RandomizeChampion()
     if (isRandomizing.load())
         return; // Don't start a new randomization if one is in progress
 
+    if (dataManager.GetChampionRecords().empty())
+        return;
+
     isRandomizing.store(true);
     hasRandomChampion.store(false);
-    const auto &championNames = dataManager.GetChampionNames();
 
-    randomizationThread = std::thread([this, championNames]()
-                                      {
-		std::vector<size_t> indices(championNames.size());
-		std::iota(indices.begin(), indices.end(), 0);
-
-		std::random_device rd;
-		std::mt19937 g(rd());
-		std::shuffle(indices.begin(), indices.end(), g);
+    // picked in advance so UpdatePrefetch() has been warming its assets, and the one after is picked now
+    int pick = nextRandomChampion.load();
+    if (pick < 0)
+    {
+        pick = PickRandomChampion(selectedChampionIndex);
+    }
+    nextRandomChampion.store(PickRandomChampion(pick));
 
+    randomizationThread = std::thread([this, pick]()
+                                      {
 		// Select a single random champion
 		{
 			std::lock_guard<std::mutex> lock(tipMutex);
-			selectedChampionIndex = indices[0];
+			selectedChampionIndex = pick;
 		}
 
 		isRandomizing.store(false);
@@ -1228,29 +1271,21 @@ void GUIManager::RenderItemsWindow()
         ImGui::PopItemWidth();
         ImGui::Separator();
 
-        for (int i = 0; i < itemNames.size(); i++)
+        for (uint32_t match : itemSearch.Update(dataManager.GetItemSearchIndex(), searchBuffer))
         {
-            std::string lowerItemName = itemNames[i];
-            std::transform(lowerItemName.begin(), lowerItemName.end(), lowerItemName.begin(), ::tolower);
-            std::string search = searchBuffer;
-            std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-            if (lowerItemName.find(search) != std::string::npos)
+            int i = static_cast<int>(match);
+            bool is_selected = (comboSelectedIndex == i);
+            if (ImGui::Selectable(itemNames[i].c_str(), is_selected))
             {
-                bool is_selected = (comboSelectedIndex == i);
-                if (ImGui::Selectable(itemNames[i].c_str(), is_selected))
+                if (comboSelectedIndex != i)
                 {
-                    if (comboSelectedIndex != i)
-                    {
-                        comboSelectedIndex = i;
-                        std::string itemId = dataManager.GetItemId(itemNames[i]);
-                        DisplayItem(itemId);
-                        selectedItemIndex = 0;
-                    }
+                    comboSelectedIndex = i;
+                    DisplayItem(dataManager.GetItemStore().Id(i));
+                    selectedItemIndex = 0;
                 }
-                if (is_selected)
-                    ImGui::SetItemDefaultFocus();
             }
+            if (is_selected)
+                ImGui::SetItemDefaultFocus();
         }
         ImGui::EndCombo();
     }
@@ -1310,30 +1345,31 @@ void GUIManager::RenderItemsWindow()
         ImGui::BeginChild("ItemsList", ImVec2(ImGui::GetWindowWidth() - 50, 300), true);
         ImGui::Indent(2.5f);
         int itemsPerRow = 13;
+        const ItemStore &items = dataManager.GetItemStore();
+        // frames and icons on separate channels, so the icons batch per atlas page
+        ImGui::GetWindowDrawList()->ChannelsSplit(2);
         for (int i = 0; i < currentItems.size(); i++)
         {
-            const auto &itemId = currentItems[i];
-            std::string itemName = dataManager.GetSpecificItemName(itemId);
-            std::string itemIconUrl = dataManager.GetItemImageUrl(itemId);
-            GLuint itemTexture = LoadTextureFromURL(itemIconUrl);
+            ItemHandle item = currentItems[i];
+            TextureLoader::Icon itemIcon = LoadItemIcon(item);
 
             if (i % itemsPerRow != 0)
                 ImGui::SameLine();
-            // if (ImGui::ImageButton((void*)(intptr_t)itemTexture, ImVec2(64, 64))) {
-            if (ImGui::ImageButton("", (ImTextureID)(intptr_t)itemTexture, ImVec2(64, 64)))
+            if (IconButton("", textureLoader.DrawIcon(itemIcon), ImVec2(64, 64)))
             {
                 if (selectedItemIndex != i)
                 {
-                    UpdateItemState(itemId, "", false, i, true);
+                    UpdateItemState(items.Id(item), "", false, i, true);
                 }
             }
             if (ImGui::IsItemHovered())
             {
                 ImGui::BeginTooltip();
-                ImGui::Text("%s", itemName.c_str());
+                ImGui::Text("%s", items.Name(item));
                 ImGui::EndTooltip();
             }
         }
+        ImGui::GetWindowDrawList()->ChannelsMerge();
         ImGui::Unindent(2.5f);
         ImGui::EndChild();
     }
@@ -1347,8 +1383,8 @@ void GUIManager::RenderItemsWindow()
     // Display item details only if an item is selected
     if (!currentItems.empty() && selectedItemIndex >= 0 && selectedItemIndex < currentItems.size())
     {
-        std::string itemId = currentItems[selectedItemIndex];
-        currentItemTags = dataManager.GetItemTags(itemId);
+        const ItemStore &items = dataManager.GetItemStore();
+        ItemHandle item = currentItems[selectedItemIndex];
 
         float columnWidth = (ImGui::GetWindowWidth() - 50) / 2;
         ImVec2 statsWindowPos = ImGui::GetCursorPos();
@@ -1357,39 +1393,46 @@ void GUIManager::RenderItemsWindow()
         ImGui::SetCursorPos(ImVec2(25, ImGui::GetCursorPosY()));
         ImGui::BeginChild("ItemDetails", ImVec2(columnWidth - 10, 200), true);
         ImGui::Indent(5.0f);
-        ImGui::Text("Name: %s", dataManager.GetSpecificItemName(itemId).c_str());
-        ImGui::Text("Description: %s", dataManager.GetItemDescription(itemId).c_str());
-        int cost = dataManager.GetItemCost(itemId);
+        ImGui::Text("Name: %s", items.Name(item));
+        ImGui::Text("Description: %s", items.Description(item));
+        int cost = items.Cost(item);
         if (cost >= 0)
             ImGui::Text("Cost: %d", cost);
 
-        auto stats = dataManager.GetItemStats(itemId);
-        if (!stats.empty())
+        // One row of the stat matrix; columns the item lacks are zero
+        Span<float> flatStats = items.FlatStats(item);
+        Span<float> percentStats = items.PercentStats(item);
+        bool statsHeader = false;
+        for (size_t stat = 0; stat < flatStats.size(); stat++)
         {
-            ImGui::Text("Stats:");
-            for (auto &[statName, statValue] : stats.items())
+            if (flatStats[stat] == 0 && percentStats[stat] == 0)
+                continue;
+            if (!statsHeader)
             {
-                if (statValue.contains("flat") && statValue["flat"].get<float>() != 0)
-                {
-                    ImGui::Text("  %s: %.2f", statName.c_str(), statValue["flat"].get<float>());
-                }
-                if (statValue.contains("percent") && statValue["percent"].get<float>() != 0)
-                {
-                    ImGui::Text("  %s: %.2f%%", statName.c_str(), statValue["percent"].get<float>());
-                }
+                ImGui::Text("Stats:");
+                statsHeader = true;
+            }
+            const char *statName = items.StatNames()[stat].c_str();
+            if (flatStats[stat] != 0)
+            {
+                ImGui::Text("  %s: %.2f", statName, flatStats[stat]);
+            }
+            if (percentStats[stat] != 0)
+            {
+                ImGui::Text("  %s: %.2f%%", statName, percentStats[stat]);
             }
         }
 
-        auto itemData = dataManager.GetItemData(itemId);
-        if (itemData.contains("active") && !itemData["active"].empty())
+        Span<ItemStore::Active> actives = items.Actives(item);
+        if (!actives.empty())
         {
             ImGui::Text("Active Ability:");
-            for (const auto &active : itemData["active"])
+            for (const auto &active : actives)
             {
-                ImGui::TextWrapped("  %s: %s", active["name"].get<std::string>().c_str(), active["effects"].get<std::string>().c_str());
-                if (active.contains("cooldown") && !active["cooldown"].is_null())
+                ImGui::TextWrapped("  %s: %s", active.name, active.effects);
+                if (active.cooldown[0] != '\0')
                 {
-                    ImGui::Text("  Cooldown: %s", active["cooldown"].get<std::string>().c_str());
+                    ImGui::Text("  Cooldown: %s", active.cooldown);
                 }
             }
         }
@@ -1401,26 +1444,21 @@ void GUIManager::RenderItemsWindow()
         ImGui::BeginChild("BuildsInto", ImVec2(columnWidth - 10, 200), true);
         ImGui::Indent(5.0f);
         ImGui::Text("Builds Into:");
-        std::vector<std::string> buildsInto = dataManager.GetItemBuildsInto(itemId);
+        Span<ItemHandle> buildsInto = items.BuildsInto(item);
         if (!buildsInto.empty())
         {
-            for (const auto &buildItemId : buildsInto)
+            ImGui::GetWindowDrawList()->ChannelsSplit(2);
+            for (ItemHandle buildItem : buildsInto)
             {
-                if (dataManager.ItemExists(buildItemId))
+                if (IconButton("", textureLoader.DrawIcon(LoadItemIcon(buildItem)), ImVec2(32, 32)))
                 {
-                    std::string buildItemName = dataManager.GetSpecificItemName(buildItemId);
-                    std::string buildItemIconUrl = dataManager.GetItemImageUrl(buildItemId);
-                    GLuint buildItemTexture = LoadTextureFromURL(buildItemIconUrl);
-                    // if (ImGui::ImageButton((void*)(intptr_t)buildItemTexture, ImVec2(32, 32))) {
-                    if (ImGui::ImageButton("", (ImTextureID)(intptr_t)buildItemTexture, ImVec2(32, 32)))
-                    {
-                        DisplayItem(buildItemId);
-                    }
-                    ImGui::SameLine();
-                    ImGui::Text("%s", buildItemName.c_str());
-                    ImGui::Separator();
+                    DisplayItem(items.Id(buildItem));
                 }
+                ImGui::SameLine();
+                ImGui::Text("%s", items.Name(buildItem));
+                ImGui::Separator();
             }
+            ImGui::GetWindowDrawList()->ChannelsMerge();
         }
         else
         {
@@ -1474,16 +1512,15 @@ void GUIManager::RenderItemsDetail()
     }
 
     // Display item icons as buttons
-    for (const auto &itemId : currentItems)
+    ImGui::GetWindowDrawList()->ChannelsSplit(2);
+    for (ItemHandle item : currentItems)
     {
-        std::string itemIconUrl = dataManager.GetItemImageUrl(itemId);
-        GLuint itemTexture = LoadTextureFromURL(itemIconUrl); // Load the texture
-        // if (ImGui::ImageButton((void*)(intptr_t)itemTexture, ImVec2(64, 64))) {
-        if (ImGui::ImageButton("", (ImTextureID)(intptr_t)itemTexture, ImVec2(64, 64)))
+        if (IconButton("", textureLoader.DrawIcon(LoadItemIcon(item)), ImVec2(64, 64)))
         {
-            DisplayItem(itemId);
+            DisplayItem(dataManager.GetItemStore().Id(item));
         }
     }
+    ImGui::GetWindowDrawList()->ChannelsMerge();
 }
 
 void GUIManager::DisplayItemsByTag(const std::string &tag)
@@ -1491,48 +1528,87 @@ void GUIManager::DisplayItemsByTag(const std::string &tag)
     UpdateItemState("", tag, true, 0, true);
 }
 
-GLuint GUIManager::LoadTextureFromURL(const std::string &url)
+TextureLoader::Icon GUIManager::LoadIconFromURL(const std::string &url)
 {
-    // Check if the texture is already loaded
-    if (itemTextures.find(url) != itemTextures.end())
+    // Check if the icon is already loaded or loading
+    auto it = iconsByUrl.find(url);
+    if (it != iconsByUrl.end())
     {
-        return itemTextures[url];
+        return it->second;
     }
 
-    CURL *curl = curl_easy_init();
-    GLuint texture = 0;
-    if (curl)
-    {
-        std::string imageData;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &imageData);
+    TextureLoader::Icon icon = textureLoader.RequestIcon(url);
+    iconsByUrl[url] = icon;
+    return icon;
+}
 
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+/**
+ * Icon texture of an item, looked up by handle so the grid does not hash URLs every frame.
+ */
+TextureLoader::Icon GUIManager::LoadItemIcon(ItemHandle item)
+{
+    if (item >= itemIcons.size())
+    {
+        itemIcons.resize(dataManager.GetItemStore().Size(), TextureLoader::kNoIcon);
+    }
+    if (itemIcons[item] == TextureLoader::kNoIcon)
+    {
+        itemIcons[item] = LoadIconFromURL(dataManager.GetItemStore().IconUrl(item));
+    }
+    return itemIcons[item];
+}
 
-        if (res == CURLE_OK)
-        {
-            int width, height, channels;
-            unsigned char *image = stbi_load_from_memory(
-                reinterpret_cast<const unsigned char *>(imageData.data()),
-                imageData.size(), &width, &height, &channels, 4);
+/**
+ * ImageButton look-alike drawn from an atlas or sprite sheet region. Inside a ChannelsSplit(2) block the frame goes to
+ * channel 0 and the icon to channel 1, so icons sharing an atlas page or sheet merge into one draw call.
+ */
+bool GUIManager::IconButton(const char *id, const TextureAtlas::Region &region, const ImVec2 &size)
+{
+    const ImGuiStyle &style = ImGui::GetStyle();
+    ImVec2 padding = style.FramePadding;
+    bool pressed = ImGui::InvisibleButton(id, ImVec2(size.x + padding.x * 2, size.y + padding.y * 2));
+    ImVec2 min = ImGui::GetItemRectMin();
+    ImVec2 max = ImGui::GetItemRectMax();
+    ImGuiCol color = ImGui::IsItemActive() ? ImGuiCol_ButtonActive : ImGui::IsItemHovered() ? ImGuiCol_ButtonHovered : ImGuiCol_Button;
+
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    drawList->ChannelsSetCurrent(0);
+    drawList->AddRectFilled(min, max, ImGui::GetColorU32(color), style.FrameRounding);
+    drawList->ChannelsSetCurrent(1);
+    drawList->AddImage((ImTextureID)(intptr_t)region.texture,
+                       ImVec2(min.x + padding.x, min.y + padding.y), ImVec2(max.x - padding.x, max.y - padding.y),
+                       ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
+    drawList->ChannelsSetCurrent(0);
+    return pressed;
+}
 
-            if (image)
-            {
-                glGenTextures(1, &texture);
-                glBindTexture(GL_TEXTURE_2D, texture);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-                stbi_image_free(image);
-
-                // Cache the loaded texture
-                itemTextures[url] = texture;
-            }
-        }
+/**
+ * Region of a sprite inside its sheet, requesting the sheet the first time it is drawn. Transparent until the sheet is loaded.
+ */
+TextureAtlas::Region GUIManager::SpriteRegion(const DataManager::Sprite &sprite)
+{
+    auto it = spriteSheets.find(sprite.sheet);
+    if (it == spriteSheets.end())
+    {
+        it = spriteSheets.emplace(sprite.sheet, textureLoader.Request(dataManager.GetSpriteUrl(sprite.sheet))).first;
     }
-    return texture;
+
+    TextureAtlas::Region region;
+    region.texture = it->second;
+    int width = 0, height = 0;
+    if (!textureLoader.GetSize(region.texture, width, height))
+    {
+        return region;  // the 1x1 placeholder
+    }
+    region.x = sprite.x;
+    region.y = sprite.y;
+    region.width = sprite.w;
+    region.height = sprite.h;
+    region.u0 = static_cast<float>(sprite.x) / width;
+    region.v0 = static_cast<float>(sprite.y) / height;
+    region.u1 = static_cast<float>(sprite.x + sprite.w) / width;
+    region.v1 = static_cast<float>(sprite.y + sprite.h) / height;
+    return region;
 }
 
 void GUIManager::DisplayItem(const std::string &itemId)
@@ -1557,7 +1633,8 @@ void GUIManager::UpdateItemState(const std::string &itemId, const std::string &t
 
     if (isTagView)
     {
-        currentItems = dataManager.GetItemsByTag(tag);
+        Span<ItemHandle> taggedItems = dataManager.GetItemsByTag(tag);
+        currentItems.assign(taggedItems.begin(), taggedItems.end());
         currentTag = tag;
         selectedItemIndex = -1;
         comboSelectedIndex = -1;
@@ -1565,12 +1642,13 @@ void GUIManager::UpdateItemState(const std::string &itemId, const std::string &t
     }
     else
     {
-        if (!dataManager.ItemExists(itemId))
+        ItemHandle item = dataManager.GetItemStore().Find(itemId);
+        if (item == kInvalidItem)
         {
             std::cerr << "Invalid item ID: " << itemId << std::endl;
             return;
         }
-        currentItems = {itemId};
+        currentItems = {item};
         // Don't clear currentTag here
         selectedItemIndex = 0;
         comboSelectedIndex = -1;
@@ -1582,12 +1660,8 @@ void GUIManager::UpdateItemState(const std::string &itemId, const std::string &t
             currentTag = currentItemTags[0];
         }
 
-        const auto &allItems = dataManager.GetItemNames();
-        auto it = std::find(allItems.begin(), allItems.end(), dataManager.GetSpecificItemName(itemId));
-        if (it != allItems.end())
-        {
-            comboSelectedIndex = std::distance(allItems.begin(), it);
-        }
+        // Item names are listed in handle order
+        comboSelectedIndex = static_cast<int>(item);
     }
 }
 
@@ -1700,28 +1774,20 @@ void GUIManager::RenderSummonerSpellsWindow()
         ImGui::PopItemWidth();
         ImGui::Separator();
 
-        for (int i = 0; i < gameModes.size(); i++)
+        for (uint32_t match : gameModeSearch.Update(dataManager.GetGameModeSearchIndex(), gameModeSearchBuffer))
         {
+            int i = static_cast<int>(match);
             const auto &gameMode = gameModes[i];
 
-            // Convert search and game mode to lowercase for case-insensitive comparison
-            std::string search = gameModeSearchBuffer;
-            std::string mode = gameMode.mode;
-            std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-            std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
-
-            if (mode.find(search) != std::string::npos)
+            bool is_selected = (selectedGameModeIndex == i);
+            if (ImGui::Selectable(gameMode.mode.c_str(), is_selected))
             {
-                bool is_selected = (selectedGameModeIndex == i);
-                if (ImGui::Selectable(gameMode.mode.c_str(), is_selected))
-                {
-                    selectedGameModeIndex = i;
-                }
+                selectedGameModeIndex = i;
+            }
 
-                if (is_selected)
-                {
-                    ImGui::SetItemDefaultFocus();
-                }
+            if (is_selected)
+            {
+                ImGui::SetItemDefaultFocus();
             }
         }
         ImGui::EndCombo();
@@ -1760,6 +1826,7 @@ void GUIManager::RenderSummonerSpellsWindow()
 
             static int selectedSpellIndex = -1;
 
+            ImGui::GetWindowDrawList()->ChannelsSplit(2);
             for (size_t i = 0; i < spells.size(); ++i)
             {
                 if (i % iconsPerRow == 0)
@@ -1773,11 +1840,12 @@ void GUIManager::RenderSummonerSpellsWindow()
                 }
 
                 const auto &spell = spells[i];
-                GLuint texture = LoadSummonerSpellTexture(spell.id);
+                TextureAtlas::Region region = useSpriteSheets && spell.sprite.IsValid()
+                                                  ? SpriteRegion(spell.sprite)
+                                                  : textureLoader.DrawIcon(LoadSummonerSpellIcon(spell.id));
 
                 ImGui::PushID(static_cast<int>(i));
-                // if (ImGui::ImageButton((void*)(intptr_t)texture, ImVec2(iconSize, iconSize))) {
-                if (ImGui::ImageButton("", (ImTextureID)(intptr_t)texture, ImVec2(iconSize, iconSize)))
+                if (IconButton("", region, ImVec2(iconSize, iconSize)))
                 {
                     selectedSpellIndex = static_cast<int>(i);
                 }
@@ -1790,6 +1858,7 @@ void GUIManager::RenderSummonerSpellsWindow()
                     ImGui::EndTooltip();
                 }
             }
+            ImGui::GetWindowDrawList()->ChannelsMerge();
 
             // Display chat box for selected spell
             if (selectedSpellIndex >= 0 && selectedSpellIndex < spells.size())
@@ -1869,15 +1938,15 @@ void GUIManager::RenderSummonerSpellsWindow()
     }
 }
 
-GLuint GUIManager::LoadSummonerSpellTexture(const std::string &spellId)
+TextureLoader::Icon GUIManager::LoadSummonerSpellIcon(const std::string &spellId)
 {
-    if (summonerSpellTextures.find(spellId) != summonerSpellTextures.end())
+    if (summonerSpellIcons.find(spellId) != summonerSpellIcons.end())
     {
-        return summonerSpellTextures[spellId];
+        return summonerSpellIcons[spellId];
     }
 
-    std::string url = "https://ddragon.leagueoflegends.com/cdn/14.14.1/img/spell/" + spellId + ".png";
-    GLuint texture = LoadTextureFromURL(url);
-    summonerSpellTextures[spellId] = texture;
-    return texture;
+    std::string url = "https://ddragon.leagueoflegends.com/cdn/" + dataManager.GetPatchVersion() + "/img/spell/" + spellId + ".png";
+    TextureLoader::Icon icon = LoadIconFromURL(url);
+    summonerSpellIcons[spellId] = icon;
+    return icon;
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <vector>
 #include <string>
 #include "DataManager.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
 #include <atomic>
 #include <thread>
 #include <mutex>
@@ -19,6 +21,7 @@
 #include <future>
 #include <thread>
 #include <numeric>
+#include <filesystem>
 //#include "resource1.h"
 
 class GUIManager {
@@ -32,6 +35,8 @@ public:
     void Render();
     void Cleanup();
     void SetWindowOffset(float offset) { windowOffset = offset; }
+    void SetSpriteSheets(bool enabled) { useSpriteSheets = enabled; }
+    void SetTextureBudget(size_t bytes) { textureCache.SetBudget(bytes); }
     void RandomizeChampion();
 
     void RenderItemsDetail();
@@ -41,7 +46,13 @@ private:
     GLFWwindow* window;
     GLuint backgroundTexture;
     GLuint LoadTexture(const char* filename);
-    GLuint championSplashTexture;
+    std::string championSplashUrl;
+    std::string championTileUrl;        // small stand-in while the splash loads
+    int championSplashFrame = -1;       // frame the splash was first drawn in
+    double championSplashReadyTime = -1.0;
+    HttpTransport::CancelToken championCancel;  // splash and tile of the champion shown, cancelled when it changes
+    HttpTransport::CancelToken skinCancel;      // skin shown, cancelled when the skin or the champion changes
+    size_t skinCancelIndex = SIZE_MAX;          // skin skinCancel was made for
     GLuint championIconTexture;
     ImFont* smallFont;
     ImFont* defaultFont;
@@ -58,9 +69,13 @@ private:
     WindowState currentState;
 
     DataManager dataManager;  
+    TextureLoader textureLoader;  // after dataManager, whose transport it uses
+    TextureCache textureCache;    // splashes and skins, bounded by a GPU memory budget
     int selectedChampionIndex;
+    SearchIndex::Query championSearch;
 
     std::future<void> championDataFuture;
+    std::future<bool> championPrefetchFuture;
     std::future<GLuint> championSplashFuture;
     std::future<GLuint> championIconFuture;
     std::vector<std::future<GLuint>> skillIconFutures;
@@ -73,18 +88,23 @@ private:
     void RenderChampionsWindow();   
     void RenderItemsWindow();
 
-    void CleanupSkinTextures();
-
     bool isChampionSplashLoaded;
     bool LoadIconTexture(const char* filename);
-    void LoadSkillIcons(const std::string& championId);
-    void LoadSkillIcon(const std::string& iconFilename, int index);
-    GLuint LoadSkinTexture(const std::string& url);
+    void LoadSkillIcons(const std::string& championId, const DataManager::ChampionDetails& details);
+    void LoadSkillIcon(const DataManager::ChampionAbility& ability, int index);
     void RandomizeTips(const std::vector<std::string>& tips, std::vector<size_t>& indices);
+
+    // predictive prefetch, see UpdatePrefetch()
+    int hoveredChampion = -1;                   // in the champion list this frame
+    int hoveredNeighbours[2] = {-1, -1};        // entries above and below it
+    std::atomic<int> nextRandomChampion{-1};    // what the next Random Champion press picks
+    int prefetchState[6] = {-2, -2, -2, -2, -2, -2};  // inputs of the last prefetch list
+    void UpdatePrefetch();
+    int PickRandomChampion(int exclude);
     bool isChampionIconLoaded;
     void LoadChampionSplash(const std::string& championName);
+    void RenderChampionSplash();
     void LoadChampionIcon(const std::string& championName);
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
     bool isDragging = false;
     ImVec2 dragStartPos;
     bool isResizing = false;
@@ -100,7 +120,6 @@ private:
     std::map<std::string, std::string> skillDescriptions;
     bool showSkins = false;
     size_t currentSkinIndex = 0;
-    std::map<std::string, GLuint> skinTextures;
     std::vector<std::string> allyTips;
     std::vector<std::string> enemyTips;
     std::vector<size_t> tipIndices;
@@ -133,7 +152,8 @@ private:
     };
 
     std::vector<std::string> currentItemTags;
-    std::vector<std::string> currentItems;
+    std::vector<ItemHandle> currentItems;
+    SearchIndex::Query itemSearch;
     int comboSelectedIndex = -1;
     bool showFighterItems = false;
     bool showMarksmanItems = false;
@@ -142,7 +162,8 @@ private:
     bool showTankItems = false;
     bool showSupportItems = false;
     int selectedItemIndex = -1;
-    std::map<std::string, GLuint> itemTextures;
+    std::map<std::string, TextureLoader::Icon> iconsByUrl;
+    std::vector<TextureLoader::Icon> itemIcons;  // by ItemHandle, kNoIcon until requested
     std::vector<ItemHistoryEntry> backwardHistory;
     std::filesystem::path historyFilePath;
     std::vector<std::string> forwardHistory;
@@ -150,7 +171,14 @@ private:
     size_t currentHistoryIndex;
     std::string currentTag;
 
-    GLuint LoadTextureFromURL(const std::string& url);
+    TextureLoader::Icon LoadIconFromURL(const std::string& url);
+    TextureLoader::Icon LoadItemIcon(ItemHandle item);
+    bool IconButton(const char* id, const TextureAtlas::Region& region, const ImVec2& size);
+
+    // champion, passive, ability and summoner spell icons cut from the img/sprite sheets, a few requests for every icon
+    bool useSpriteSheets = true;
+    std::map<std::string, GLuint> spriteSheets;  // by sheet file name
+    TextureAtlas::Region SpriteRegion(const DataManager::Sprite& sprite);
     void DisplayItem(const std::string& itemId);
     void UpdateItemState(const std::string& itemId, const std::string& tag, bool isTagView, int selectedIndex, bool addToHistory);
     void InitializeHistory();
@@ -165,8 +193,9 @@ private:
     void RenderSummonerSpellsWindow();
     int selectedGameModeIndex = -1;
     char gameModeSearchBuffer[256] = "";
-    std::map<std::string, GLuint> summonerSpellTextures;
-    GLuint LoadSummonerSpellTexture(const std::string& spellId);
+    SearchIndex::Query gameModeSearch;
+    std::map<std::string, TextureLoader::Icon> summonerSpellIcons;
+    TextureLoader::Icon LoadSummonerSpellIcon(const std::string& spellId);
 
 
 };
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include "HttpCache.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+
+static int64_t NowSeconds()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static const uint64_t fnvOffsetBasis = 14695981039346656037ull;
+
+/**
+ * FNV-1a 64 bit hash, stable across runs so it can name files on disk. Continues from hash,
+ * so a body can be hashed chunk by chunk.
+ */
+static uint64_t Fnv1a(uint64_t hash, const char *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static std::string Hex(uint64_t hash)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i)
+    {
+        hex[i] = digits[hash & 0xF];
+        hash >>= 4;
+    }
+    return hex;
+}
+
+std::string HttpCache::HashUrl(const std::string &url)
+{
+    return Hex(Fnv1a(fnvOffsetBasis, url.data(), url.size()));
+}
+
+std::string HttpCache::HashBody(const std::string &body)
+{
+    return Hex(Fnv1a(fnvOffsetBasis, body.data(), body.size()));
+}
+
+HttpCache::HttpCache(HttpTransport &transport, const std::filesystem::path &directory, int64_t defaultMaxAgeSeconds)
+    : transport(transport), directory(directory), defaultMaxAge(defaultMaxAgeSeconds)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to create cache directory " << directory << ": " << ec.message() << std::endl;
+    }
+}
+
+bool HttpCache::Get(const std::string &url, std::string &body, const HttpTransport::DataCallback &onData,
+                    HttpTransport::Priority priority)
+{
+    Entry entry;
+    std::string cachedBody;
+    bool cached = LoadEntry(url, entry, cachedBody);
+    int64_t now = NowSeconds();
+
+    auto serveCached = [&]()
+    {
+        body = std::move(cachedBody);
+        if (onData)
+        {
+            onData(body.data(), body.size());
+        }
+        return true;
+    };
+
+    if (cached && now - entry.storedAt < entry.maxAge)
+    {
+        hits++;
+        return serveCached();
+    }
+
+    std::vector<std::string> headers;
+    if (cached && !entry.etag.empty())
+    {
+        headers.push_back("If-None-Match: " + entry.etag);
+    }
+    if (cached && !entry.lastModified.empty())
+    {
+        headers.push_back("If-Modified-Since: " + entry.lastModified);
+    }
+
+    // once part of a fresh body has been handed out, falling back to the stale one would mix the two
+    bool streamed = false;
+    // a streamed body is not held in memory, it goes to a temporary file that becomes the entry's body
+    std::filesystem::path streamPath;
+    std::ofstream streamFile;
+    uint64_t streamHash = fnvOffsetBasis;
+    HttpTransport::DataCallback forward;
+    if (onData)
+    {
+        forward = [&](const char *data, size_t size)
+        {
+            if (!streamed)
+            {
+                streamed = true;
+                streamPath = PathFor(url, ".body");
+                streamPath += "." + std::to_string(streamCounter++) + ".tmp";
+                streamFile.open(streamPath, std::ios::binary | std::ios::trunc);
+            }
+            streamFile.write(data, size);
+            streamHash = Fnv1a(streamHash, data, size);
+            onData(data, size);
+        };
+    }
+
+    Response response;
+    bool performed = Perform(url, headers, forward, priority, response);
+    std::error_code ec;
+    if (streamed)
+    {
+        streamFile.close();
+    }
+    if (!performed)
+    {
+        if (streamed)
+        {
+            std::filesystem::remove(streamPath, ec);
+        }
+        if (cached && !streamed)
+        {
+            staleFallbacks++;
+            std::cerr << "Network unavailable, using stale cache for " << url << std::endl;
+            return serveCached();
+        }
+        return false;
+    }
+
+    if (response.status == 304 && cached)
+    {
+        revalidations++;
+        entry.storedAt = now;
+        entry.maxAge = response.maxAge >= 0 ? response.maxAge : defaultMaxAge;
+        StoreEntry(entry, nullptr);
+        return serveCached();
+    }
+
+    if (response.status != 200)
+    {
+        if (cached)
+        {
+            staleFallbacks++;
+            return serveCached();
+        }
+        std::cerr << "HTTP " << response.status << " for " << url << std::endl;
+        return false;
+    }
+
+    misses++;
+    entry.url = url;
+    entry.etag = response.etag;
+    entry.lastModified = response.lastModified;
+    entry.storedAt = now;
+    entry.maxAge = response.maxAge >= 0 ? response.maxAge : defaultMaxAge;
+    if (streamed)
+    {
+        entry.bodyHash = Hex(streamHash);
+        if (!streamFile)
+        {
+            std::cerr << "Failed to write cache body for " << url << std::endl;
+            std::filesystem::remove(streamPath, ec);
+        }
+        else
+        {
+            StoreEntry(entry, nullptr, &streamPath);
+        }
+        body.clear();
+        return true;
+    }
+    StoreEntry(entry, &response.body);
+    body = std::move(response.body);
+    return true;
+}
+
+HttpCache::Stats HttpCache::GetStats() const
+{
+    Stats stats;
+    stats.hits = hits.load();
+    stats.misses = misses.load();
+    stats.revalidations = revalidations.load();
+    stats.staleFallbacks = staleFallbacks.load();
+    return stats;
+}
+
+const std::filesystem::path &HttpCache::GetDirectory() const
+{
+    return directory;
+}
+
+std::filesystem::path HttpCache::PathFor(const std::string &url, const char *extension) const
+{
+    return directory / (HashUrl(url) + extension);
+}
+
+bool HttpCache::LoadEntry(const std::string &url, Entry &entry, std::string &body) const
+{
+    std::ifstream metaFile(PathFor(url, ".json"));
+    std::ifstream bodyFile(PathFor(url, ".body"), std::ios::binary);
+    if (!metaFile || !bodyFile)
+    {
+        return false;
+    }
+
+    try
+    {
+        auto meta = nlohmann::json::parse(metaFile);
+        if (meta.value("url", "") != url)
+        {
+            return false; // hash collision
+        }
+        entry.url = url;
+        entry.etag = meta.value("etag", "");
+        entry.lastModified = meta.value("lastModified", "");
+        entry.storedAt = meta.value("storedAt", int64_t(0));
+        entry.maxAge = meta.value("maxAge", int64_t(0));
+        entry.bodyHash = meta.value("bodyHash", "");
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Corrupt cache entry for " << url << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    std::ostringstream buffer;
+    buffer << bodyFile.rdbuf();
+    body = buffer.str();
+
+    // meta and body are renamed separately, a crash in between leaves a torn pair
+    if (HashBody(body) != entry.bodyHash)
+    {
+        std::cerr << "Cache body does not match its metadata for " << url << std::endl;
+        body.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Writes entry's meta, with body or the temporary file streamedBody as its new body. A
+ * streamed body is already hashed into entry.bodyHash. Without either the body is kept.
+ */
+bool HttpCache::StoreEntry(Entry &entry, const std::string *body, const std::filesystem::path *streamedBody)
+{
+    if (body)
+    {
+        entry.bodyHash = HashBody(*body);
+    }
+    nlohmann::json meta = {
+        {"url", entry.url},
+        {"etag", entry.etag},
+        {"lastModified", entry.lastModified},
+        {"storedAt", entry.storedAt},
+        {"maxAge", entry.maxAge},
+        {"bodyHash", entry.bodyHash}};
+
+    // Write to temporary files and rename, so readers never see a partial entry
+    std::lock_guard<std::mutex> lock(storeMutex);
+    std::error_code ec;
+    if (body || streamedBody)
+    {
+        auto bodyPath = PathFor(entry.url, ".body");
+        auto tmpPath = streamedBody ? *streamedBody : bodyPath;
+        if (body)
+        {
+            tmpPath += ".tmp";
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            file.write(body->data(), body->size());
+            if (!file)
+            {
+                std::cerr << "Failed to write cache body for " << entry.url << std::endl;
+                return false;
+            }
+        }
+        std::filesystem::rename(tmpPath, bodyPath, ec);
+        if (ec)
+        {
+            // the old meta still names the old body, leave it so the pair stays consistent
+            std::cerr << "Failed to store cache body for " << entry.url << ": " << ec.message() << std::endl;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    auto metaPath = PathFor(entry.url, ".json");
+    auto tmpPath = metaPath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        file << meta.dump();
+        file.flush();
+        if (!file)
+        {
+            std::cerr << "Failed to write cache metadata for " << entry.url << std::endl;
+            file.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, metaPath, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to store cache entry for " << entry.url << ": " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool HttpCache::Perform(const std::string &url, const std::vector<std::string> &headers, const HttpTransport::DataCallback &onData,
+                        HttpTransport::Priority priority, Response &response) const
+{
+    HttpTransport::Response result = transport.Fetch(url, headers, onData, {}, priority).get();
+    if (!result.ok)
+    {
+        std::cerr << "Request failed for " << url << ": " << result.error << std::endl;
+        return false;
+    }
+
+    response.status = result.status;
+    response.body = std::move(result.body);
+    for (const auto &[name, value] : result.headers)
+    {
+        if (name == "etag")
+        {
+            response.etag = value;
+        }
+        else if (name == "last-modified")
+        {
+            response.lastModified = value;
+        }
+        else if (name == "cache-control")
+        {
+            size_t pos = value.find("max-age=");
+            if (pos != std::string::npos)
+            {
+                response.maxAge = std::strtoll(value.c_str() + pos + 8, nullptr, 10);
+            }
+        }
+    }
+    return true;
+}
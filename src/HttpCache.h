@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include "HttpTransport.h"
+
+/**
+ * @brief URL 을 키로 하는 디스크 HTTP 캐시
+ *
+ * Bodies are stored next to their ETag / Last-Modified validators. Fresh entries
+ * are served without touching the network, stale ones are revalidated with
+ * If-None-Match / If-Modified-Since, and stale data is used when the network
+ * is unavailable.
+ */
+class HttpCache {
+public:
+    struct Stats {
+        size_t hits = 0;            // served fresh from disk, no network
+        size_t misses = 0;          // full download
+        size_t revalidations = 0;   // conditional request answered with 304
+        size_t staleFallbacks = 0;  // network failed, stale entry served
+    };
+
+    HttpCache(HttpTransport& transport, const std::filesystem::path& directory, int64_t defaultMaxAgeSeconds);
+
+    /**
+     * @brief Returns the body for url, from disk or from the network.
+     *
+     * When onData is set it also receives the body, chunk by chunk while a fresh
+     * download is in progress or in one piece when it comes from disk. A streamed
+     * download goes to onData and straight to disk, body is left empty. A request
+     * that goes to the network is scheduled at priority.
+     */
+    bool Get(const std::string& url, std::string& body, const HttpTransport::DataCallback& onData = nullptr,
+             HttpTransport::Priority priority = HttpTransport::Priority::Visible);
+
+    Stats GetStats() const;
+    const std::filesystem::path& GetDirectory() const;
+
+    /**
+     * @brief Hex hash of url that names its files, shared with the other disk caches.
+     */
+    static std::string HashUrl(const std::string& url);
+
+private:
+    struct Entry {
+        std::string url;
+        std::string etag;
+        std::string lastModified;
+        int64_t storedAt = 0;  // seconds since epoch
+        int64_t maxAge = 0;    // seconds
+        std::string bodyHash;  // HashBody of the body file, so a meta paired with the wrong body is a miss
+    };
+
+    struct Response {
+        long status = 0;
+        std::string body;
+        std::string etag;
+        std::string lastModified;
+        int64_t maxAge = -1;
+    };
+
+    bool LoadEntry(const std::string& url, Entry& entry, std::string& body) const;
+    bool StoreEntry(Entry& entry, const std::string* body, const std::filesystem::path* streamedBody = nullptr);
+    bool Perform(const std::string& url, const std::vector<std::string>& headers, const HttpTransport::DataCallback& onData,
+                 HttpTransport::Priority priority, Response& response) const;
+    std::filesystem::path PathFor(const std::string& url, const char* extension) const;
+    static std::string HashBody(const std::string& body);
+
+    HttpTransport& transport;
+    std::filesystem::path directory;
+    int64_t defaultMaxAge;
+    std::mutex storeMutex;
+    std::atomic<uint64_t> streamCounter{0};  // names the temporary file of each streamed download
+
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    std::atomic<size_t> revalidations{0};
+    std::atomic<size_t> staleFallbacks{0};
+};
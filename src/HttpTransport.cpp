@@ -0,0 +1,569 @@
+#include "HttpTransport.h"
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+#include <curl/curl.h>
+
+struct HttpTransport::Transfer {
+    struct Waiter {
+        std::promise<Response> promise;
+        CancelToken cancel;
+    };
+
+    std::string url;
+    std::string host;
+    std::atomic<Priority> priority{Priority::Visible};  // raised by fetches joining it
+    Priority weighted = Priority::Visible;  // priority its stream weight was last set for, transport thread only
+    struct curl_slist *headerList = nullptr;
+    CURL *easy = nullptr;
+    Response response;
+    DataCallback onData;
+    std::vector<Waiter> waiters;    // more than one once other fetches joined, guarded by queueMutex
+    bool isShared = false;          // listed in shared, other fetches of the url may join
+
+    bool IsCancelled() const
+    {
+        return std::all_of(waiters.begin(), waiters.end(), [](const Waiter &waiter) { return waiter.cancel.IsCancelled(); });
+    }
+
+    ~Transfer()
+    {
+        curl_slist_free_all(headerList);
+    }
+};
+
+static std::string Trim(const std::string &value)
+{
+    size_t begin = value.find_first_not_of(" \t\r\n");
+    size_t end = value.find_last_not_of(" \t\r\n");
+    return begin == std::string::npos ? std::string() : value.substr(begin, end - begin + 1);
+}
+
+static std::string HostOf(const std::string &url)
+{
+    size_t begin = url.find("://");
+    begin = begin == std::string::npos ? 0 : begin + 3;
+    size_t end = url.find_first_of(":/?#", begin);
+    return url.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+/**
+ * HTTP/2 weight of a stream: streams sharing a connection get bandwidth in proportion to it.
+ */
+static long StreamWeight(HttpTransport::Priority priority)
+{
+    static const long weights[] = {256, 128, 32, 16};
+    return weights[static_cast<int>(priority)];
+}
+
+static size_t HeaderCallback(char *buffer, size_t size, size_t nitems, void *userdata)
+{
+    size_t totalSize = size * nitems;
+    std::string line(buffer, totalSize);
+    auto *headers = static_cast<std::vector<std::pair<std::string, std::string>> *>(userdata);
+
+    // a new status line starts the headers of a redirect target or of the final response
+    if (line.compare(0, 5, "HTTP/") == 0)
+    {
+        headers->clear();
+        return totalSize;
+    }
+
+    size_t colon = line.find(':');
+    if (colon == std::string::npos)
+    {
+        return totalSize;
+    }
+
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    headers->emplace_back(name, Trim(line.substr(colon + 1)));
+    return totalSize;
+}
+
+HttpTransport::HttpTransport(long maxConnectionsPerHost)
+    : defaultHostLimit(static_cast<size_t>(std::max(maxConnectionsPerHost, 1L)))
+{
+    // ddragon serves every image and champion file; the other two a single large or small JSON file each
+    hostLimits = {
+        {"ddragon.leagueoflegends.com", 8},
+        {"cdn.merakianalytics.com", 2},
+        {"static.developer.riotgames.com", 2},
+    };
+
+    // curl_easy_init() would do this lazily, but that is not safe once fetches run on several threads
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    multi = curl_multi_init();
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxConnectionsPerHost);
+
+    worker = std::thread(&HttpTransport::Run, this);
+}
+
+HttpTransport::~HttpTransport()
+{
+    stopping = true;
+    curl_multi_wakeup(multi);
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+    curl_multi_cleanup(multi);
+    curl_global_cleanup();
+}
+
+std::future<HttpTransport::Response> HttpTransport::Fetch(const std::string &url, const std::vector<std::string> &headers,
+                                                          DataCallback onData, CancelToken cancel, Priority priority)
+{
+    auto transfer = std::make_unique<Transfer>();
+    transfer->url = url;
+    transfer->host = HostOf(url);
+    transfer->priority = priority;
+    transfer->isShared = headers.empty() && !onData;
+    transfer->onData = std::move(onData);
+    for (const auto &header : headers)
+    {
+        transfer->headerList = curl_slist_append(transfer->headerList, header.c_str());
+    }
+    Transfer::Waiter waiter{std::promise<Response>(), std::move(cancel)};
+    std::future<Response> result = waiter.promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping)
+        {
+            transfer->response.error = "transport is shutting down";
+            waiter.promise.set_value(std::move(transfer->response));
+            return result;
+        }
+        if (transfer->isShared)
+        {
+            auto it = shared.find(url);
+            if (it != shared.end())
+            {
+                it->second->waiters.push_back(std::move(waiter));
+                coalesced++;
+                RaisePriority(*it->second, priority);
+                return result;
+            }
+            shared[url] = transfer.get();
+        }
+        transfer->waiters.push_back(std::move(waiter));
+        queued.push_back(std::move(transfer));
+    }
+    requests++;
+    curl_multi_wakeup(multi);
+    return result;
+}
+
+void HttpTransport::Raise(const std::string &url, Priority priority)
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    auto it = shared.find(url);
+    if (it != shared.end())
+    {
+        RaisePriority(*it->second, priority);
+    }
+}
+
+/**
+ * Caller holds queueMutex.
+ */
+void HttpTransport::RaisePriority(Transfer &transfer, Priority priority)
+{
+    if (priority < transfer.priority)
+    {
+        // may now be allowed to start, or to preempt
+        transfer.priority = priority;
+        curl_multi_wakeup(multi);
+    }
+}
+
+bool HttpTransport::Get(const std::string &url, std::string &body)
+{
+    Response response = Fetch(url).get();
+    if (!response.ok || response.status != 200)
+    {
+        std::cerr << "Failed to fetch " << url << ": "
+                  << (response.ok ? "HTTP " + std::to_string(response.status) : response.error) << std::endl;
+        return false;
+    }
+    body = std::move(response.body);
+    return true;
+}
+
+HttpTransport::Stats HttpTransport::GetStats() const
+{
+    Stats stats;
+    stats.requests = requests.load();
+    stats.connections = connections.load();
+    stats.coalesced = coalesced.load();
+    stats.cancelled = cancelled.load();
+    stats.preempted = preempted.load();
+    return stats;
+}
+
+/**
+ * 전송 스레드의 이벤트 루프.
+ */
+void HttpTransport::Run()
+{
+    while (!stopping)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            for (auto &transfer : queued)
+            {
+                waiting.push_back(std::move(transfer));
+            }
+            queued.clear();
+        }
+        bool cancellable = CancelTransfers();
+        Schedule();
+        Reweight();
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int remaining = 0;
+        while (CURLMsg *message = curl_multi_info_read(multi, &remaining))
+        {
+            if (message->msg == CURLMSG_DONE)
+            {
+                FinishTransfer(message->easy_handle, message->data.result);
+            }
+        }
+
+        // cancelled tokens are only noticed here, so wake up sooner while there are any that could be
+        curl_multi_poll(multi, nullptr, 0, cancellable ? 100 : 1000, nullptr);
+    }
+
+    // fail whatever is still pending so no caller waits forever
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (auto &transfer : queued)
+        {
+            active.push_back(std::move(transfer));
+        }
+        queued.clear();
+    }
+    for (auto &transfer : waiting)
+    {
+        active.push_back(std::move(transfer));
+    }
+    waiting.clear();
+    for (auto &transfer : active)
+    {
+        if (transfer->easy)
+        {
+            curl_multi_remove_handle(multi, transfer->easy);
+            curl_easy_cleanup(transfer->easy);
+        }
+        transfer->response.error = "transport is shutting down";
+        Resolve(*transfer);
+    }
+    active.clear();
+    for (void *easy : idleHandles)
+    {
+        curl_easy_cleanup(easy);
+    }
+    idleHandles.clear();
+}
+
+size_t HttpTransport::WriteBody(void *contents, size_t size, size_t nmemb, void *userdata)
+{
+    size_t totalSize = size * nmemb;
+    auto *transfer = static_cast<Transfer *>(userdata);
+    if (transfer->onData)
+    {
+        long status = 0;
+        curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &status);
+        if (status == 200)
+        {
+            transfer->onData(static_cast<const char *>(contents), totalSize);
+            return totalSize;
+        }
+    }
+    transfer->response.body.append((char *)contents, totalSize);
+    return totalSize;
+}
+
+void *HttpTransport::AcquireHandle()
+{
+    if (idleHandles.empty())
+    {
+        return curl_easy_init();
+    }
+    void *easy = idleHandles.back();
+    idleHandles.pop_back();
+    curl_easy_reset(easy);
+    return easy;
+}
+
+void HttpTransport::StartTransfer(std::unique_ptr<Transfer> transfer)
+{
+    CURL *easy = AcquireHandle();
+    if (!easy)
+    {
+        transfer->response.error = "failed to initialize curl";
+        Resolve(*transfer);
+        return;
+    }
+
+    transfer->easy = easy;
+    curl_easy_setopt(easy, CURLOPT_URL, transfer->url.c_str());
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headerList);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, WriteBody);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer.get());
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, &transfer->response.headers);
+    curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);  // prefer waiting for a multiplexed stream over a new connection
+    transfer->weighted = transfer->priority.load();
+    curl_easy_setopt(easy, CURLOPT_STREAM_WEIGHT, StreamWeight(transfer->weighted));
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+
+    CURLMcode code = curl_multi_add_handle(multi, easy);
+    if (code != CURLM_OK)
+    {
+        transfer->response.error = curl_multi_strerror(code);
+        Resolve(*transfer);
+        curl_easy_cleanup(easy);
+        return;
+    }
+    active.push_back(std::move(transfer));
+}
+
+void HttpTransport::FinishTransfer(void *easy, int result)
+{
+    Transfer *finished = nullptr;
+    curl_easy_getinfo(easy, CURLINFO_PRIVATE, &finished);
+    curl_multi_remove_handle(multi, easy);
+
+    auto it = std::find_if(active.begin(), active.end(),
+                           [finished](const std::unique_ptr<Transfer> &transfer) { return transfer.get() == finished; });
+    if (it == active.end())
+    {
+        curl_easy_cleanup(easy);
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(*it);
+    active.erase(it);
+
+    long newConnections = 0;
+    curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &newConnections);
+    connections += static_cast<size_t>(newConnections);
+
+    if (result == CURLE_OK)
+    {
+        transfer->response.ok = true;
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &transfer->response.status);
+    }
+    else
+    {
+        transfer->response.error = curl_easy_strerror(static_cast<CURLcode>(result));
+    }
+
+    transfer->easy = nullptr;
+    idleHandles.push_back(easy);
+    Resolve(*transfer);
+}
+
+/**
+ * Drops the transfers every caller of which has cancelled, aborting those running, and answers the callers that
+ * cancelled a transfer others still wait for. True while any other transfer could still be cancelled.
+ */
+bool HttpTransport::CancelTransfers()
+{
+    std::vector<std::unique_ptr<Transfer>> aborted;
+    std::vector<Transfer::Waiter> released;
+    bool cancellable = false;
+    auto collect = [&aborted, &released, &cancellable](std::vector<std::unique_ptr<Transfer>> &transfers)
+    {
+        for (auto it = transfers.begin(); it != transfers.end();)
+        {
+            if ((*it)->IsCancelled())
+            {
+                aborted.push_back(std::move(*it));
+                it = transfers.erase(it);
+                continue;
+            }
+            // the transfer goes on for the rest
+            std::vector<Transfer::Waiter> &waiters = (*it)->waiters;
+            auto kept = std::stable_partition(waiters.begin(), waiters.end(),
+                                              [](const Transfer::Waiter &waiter) { return !waiter.cancel.IsCancelled(); });
+            std::move(kept, waiters.end(), std::back_inserter(released));
+            waiters.erase(kept, waiters.end());
+            cancellable = cancellable || std::any_of((*it)->waiters.begin(), (*it)->waiters.end(),
+                                                     [](const Transfer::Waiter &waiter) { return waiter.cancel.IsCancellable(); });
+            ++it;
+        }
+    };
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        collect(waiting);
+        collect(active);
+    }
+
+    for (auto &waiter : released)
+    {
+        Response response;
+        response.error = "cancelled";
+        waiter.promise.set_value(std::move(response));
+    }
+    for (auto &transfer : aborted)
+    {
+        if (transfer->easy)
+        {
+            curl_multi_remove_handle(multi, transfer->easy);
+            idleHandles.push_back(transfer->easy);
+            transfer->easy = nullptr;
+        }
+        transfer->response.error = "cancelled";
+        Resolve(*transfer);
+        cancelled++;
+    }
+    return cancellable;
+}
+
+/**
+ * Gives running transfers whose priority was raised since they started the stream weight of their new priority,
+ * so a raised transfer also wins bandwidth on a connection it shares.
+ */
+void HttpTransport::Reweight()
+{
+    for (const auto &transfer : active)
+    {
+        Priority priority = transfer->priority.load();
+        if (priority < transfer->weighted)
+        {
+            transfer->weighted = priority;
+            curl_easy_setopt(transfer->easy, CURLOPT_STREAM_WEIGHT, StreamWeight(priority));
+        }
+    }
+}
+
+/**
+ * Starts waiting transfers, most urgent first, as far as their hosts' limits allow. Prefetch and background
+ * transfers only fill half of a host's slots; a visible or near-visible one preempts them for the rest.
+ */
+void HttpTransport::Schedule()
+{
+    if (waiting.empty())
+    {
+        return;
+    }
+
+    // priorities can be raised meanwhile by fetches joining, so sort a snapshot of them
+    std::vector<std::pair<Priority, size_t>> order;
+    for (size_t i = 0; i < waiting.size(); ++i)
+    {
+        order.emplace_back(waiting[i]->priority.load(), i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<Priority, size_t> &a, const std::pair<Priority, size_t> &b) { return a.first < b.first; });
+
+    std::unordered_map<std::string, size_t> running;
+    for (const auto &transfer : active)
+    {
+        ++running[transfer->host];
+    }
+
+    std::vector<std::unique_ptr<Transfer>> waitingAgain;
+    for (const auto &[priority, index] : order)
+    {
+        std::unique_ptr<Transfer> &transfer = waiting[index];
+        size_t limit = HostLimit(transfer->host);
+        bool urgent = priority <= Priority::NearVisible;
+        size_t &count = running[transfer->host];
+        if (!urgent)
+        {
+            limit = std::max<size_t>(limit / 2, 1);
+        }
+        else if (count >= limit && Preempt(transfer->host, waitingAgain))
+        {
+            --count;
+        }
+
+        if (count < limit)
+        {
+            ++count;
+            StartTransfer(std::move(transfer));
+        }
+        else
+        {
+            waitingAgain.push_back(std::move(transfer));
+        }
+    }
+    waiting = std::move(waitingAgain);
+}
+
+/**
+ * Stops the least urgent preemptible transfer running on host, the one started last among equals, and puts it
+ * back to waiting. Transfers streaming to a DataCallback may have handed out data already and are never preempted.
+ */
+bool HttpTransport::Preempt(const std::string &host, std::vector<std::unique_ptr<Transfer>> &waitingAgain)
+{
+    auto victim = active.end();
+    for (auto it = active.begin(); it != active.end(); ++it)
+    {
+        Priority priority = (*it)->priority;
+        if ((*it)->host == host && priority >= Priority::Prefetch && !(*it)->onData &&
+            (victim == active.end() || priority >= (*victim)->priority))
+        {
+            victim = it;
+        }
+    }
+    if (victim == active.end())
+    {
+        return false;
+    }
+
+    std::unique_ptr<Transfer> transfer = std::move(*victim);
+    active.erase(victim);
+    curl_multi_remove_handle(multi, transfer->easy);
+    idleHandles.push_back(transfer->easy);
+    transfer->easy = nullptr;
+    transfer->response = Response{};  // starts over
+    waitingAgain.push_back(std::move(transfer));
+    preempted++;
+    return true;
+}
+
+size_t HttpTransport::HostLimit(const std::string &host) const
+{
+    auto it = hostLimits.find(host);
+    return it != hostLimits.end() ? it->second : defaultHostLimit;
+}
+
+/**
+ * Completes the fetches waiting on transfer, each gets its own copy of the response.
+ */
+void HttpTransport::Resolve(Transfer &transfer)
+{
+    std::vector<Transfer::Waiter> waiters;
+    {
+        // once unlisted no fetch can join, so the waiters taken here are all of them
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto it = transfer.isShared ? shared.find(transfer.url) : shared.end();
+        if (it != shared.end() && it->second == &transfer)
+        {
+            shared.erase(it);
+        }
+        waiters.swap(transfer.waiters);
+    }
+    for (size_t i = 0; i + 1 < waiters.size(); ++i)
+    {
+        waiters[i].promise.set_value(transfer.response);
+    }
+    if (!waiters.empty())
+    {
+        waiters.back().promise.set_value(std::move(transfer.response));
+    }
+}
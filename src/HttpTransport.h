@@ -0,0 +1,164 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <functional>
+
+/**
+ * @brief 모든 HTTP 요청이 공유하는 전송 계층
+ *
+ * Every request is driven by one curl multi handle on a dedicated thread, so
+ * connections stay alive per host and the DNS and TLS session caches are shared
+ * across callers. Requests to the same host are multiplexed over HTTP/2 where
+ * the server supports it, and easy handles are pooled instead of recreated.
+ *
+ * Plain GETs of a URL already in flight join that transfer instead of starting
+ * another, each caller still gets its own response. A fetch made with a
+ * CancelToken is abandoned once the token is cancelled, the transfer itself is
+ * aborted when every caller sharing it has cancelled.
+ *
+ * Transfers wait in priority order for a slot under their host's limit, which
+ * prefetch and background transfers may only fill to half. A visible or
+ * near-visible transfer that finds its host full takes the slot of a running
+ * prefetch or background transfer, which starts over once there is room, so
+ * what is on screen keeps its latency while a bulk download saturates the link.
+ */
+class HttpTransport {
+public:
+    struct Response {
+        bool ok = false;            // transfer completed, status may still be an error
+        long status = 0;
+        std::string body;
+        std::vector<std::pair<std::string, std::string>> headers;  // lower-case names
+        std::string error;
+    };
+
+    /**
+     * @brief Most urgent first. A transfer shared by several fetches runs at the most urgent of them.
+     */
+    enum class Priority {
+        Visible,                    // drawn now, or waited on
+        NearVisible,                // likely drawn next, e.g. under the mouse
+        Prefetch,
+        Background,                 // bulk refreshes nobody is waiting on
+    };
+
+    struct Stats {
+        size_t requests = 0;
+        size_t connections = 0;     // new connections opened, the rest reused one
+        size_t coalesced = 0;       // joined a transfer already in flight
+        size_t cancelled = 0;       // transfers aborted before they finished
+        size_t preempted = 0;       // prefetch or background transfers restarted to make room
+    };
+
+    /**
+     * @brief 요청을 취소할 때 쓰는 토큰
+     *
+     * Copies share one flag. A default-constructed token is never cancelled.
+     */
+    class CancelToken {
+    public:
+        static CancelToken Create()
+        {
+            CancelToken token;
+            token.flag = std::make_shared<std::atomic<bool>>(false);
+            return token;
+        }
+
+        void Cancel() const
+        {
+            if (flag)
+                *flag = true;
+        }
+
+        bool IsCancelled() const { return flag && *flag; }
+        bool IsCancellable() const { return flag != nullptr; }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> flag;
+    };
+
+    /**
+     * @brief maxConnectionsPerHost also limits concurrent transfers, except for the hosts with limits of their own.
+     */
+    explicit HttpTransport(long maxConnectionsPerHost = 6);
+    ~HttpTransport();
+
+    HttpTransport(const HttpTransport&) = delete;
+    HttpTransport& operator=(const HttpTransport&) = delete;
+
+    /**
+     * @brief Receives body chunks of a 200 response on the transport thread as they arrive.
+     *
+     * The chunks are not kept, a body handed to the callback leaves Response::body empty.
+     */
+    using DataCallback = std::function<void(const char* data, size_t size)>;
+
+    /**
+     * @brief Queues a GET request, the future is ready once the transfer finishes or cancel is cancelled.
+     *
+     * Without headers or onData the request shares a transfer of the same url that is already in flight.
+     * A cancelled fetch is answered with the error "cancelled", the transfer it shared goes on for the others.
+     */
+    std::future<Response> Fetch(const std::string& url, const std::vector<std::string>& headers = {},
+                                DataCallback onData = nullptr, CancelToken cancel = {},
+                                Priority priority = Priority::Visible);
+
+    /**
+     * @brief Raises the priority of the shared transfer of url that is queued or running, if there is one.
+     *
+     * For a caller whose fetch became more urgent while in flight, without fetching it again.
+     */
+    void Raise(const std::string& url, Priority priority);
+
+    /**
+     * @brief Blocking GET, true only for a completed 200 response.
+     */
+    bool Get(const std::string& url, std::string& body);
+
+    Stats GetStats() const;
+
+private:
+    struct Transfer;
+
+    void Run();
+    void StartTransfer(std::unique_ptr<Transfer> transfer);
+    void FinishTransfer(void* easy, int result);
+    bool CancelTransfers();
+    void Schedule();
+    void Reweight();
+    bool Preempt(const std::string& host, std::vector<std::unique_ptr<Transfer>>& waitingAgain);
+    size_t HostLimit(const std::string& host) const;
+    void Resolve(Transfer& transfer);
+    void RaisePriority(Transfer& transfer, Priority priority);
+    void* AcquireHandle();
+    static size_t WriteBody(void* contents, size_t size, size_t nmemb, void* userdata);
+
+    void* multi;
+    std::thread worker;
+    std::atomic<bool> stopping{false};
+
+    std::mutex queueMutex;
+    std::deque<std::unique_ptr<Transfer>> queued;
+    std::unordered_map<std::string, Transfer*> shared;  // plain GETs queued or running, by url
+
+    // only touched by the worker thread
+    std::vector<std::unique_ptr<Transfer>> waiting;  // for a slot under their host's limit
+    std::vector<std::unique_ptr<Transfer>> active;
+    std::vector<void*> idleHandles;
+    size_t defaultHostLimit;
+    std::unordered_map<std::string, size_t> hostLimits;
+
+    std::atomic<size_t> requests{0};
+    std::atomic<size_t> connections{0};
+    std::atomic<size_t> coalesced{0};
+    std::atomic<size_t> cancelled{0};
+    std::atomic<size_t> preempted{0};
+};
@@ -0,0 +1,310 @@
+#include "ImageCache.h"
+#include "HttpCache.h"
+#include "MappedFile.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// QOI, https://qoiformat.org/qoi-specification.pdf
+static const unsigned char kQoiOpIndex = 0x00;
+static const unsigned char kQoiOpDiff = 0x40;
+static const unsigned char kQoiOpLuma = 0x80;
+static const unsigned char kQoiOpRun = 0xC0;
+static const unsigned char kQoiOpRgb = 0xFE;
+static const unsigned char kQoiOpRgba = 0xFF;
+static const unsigned char kQoiMask = 0xC0;
+static const size_t kQoiHeaderSize = 14;
+static const unsigned char kQoiEnd[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+struct QoiPixel {
+    unsigned char r, g, b, a;
+};
+
+static int QoiHash(const QoiPixel &px)
+{
+    return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+}
+
+static void PutBigEndian(std::vector<unsigned char> &out, uint32_t value)
+{
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static uint32_t GetBigEndian(const unsigned char *in)
+{
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+}
+
+static void EncodeQoi(const unsigned char *pixels, int width, int height, std::vector<unsigned char> &out)
+{
+    out.reserve(kQoiHeaderSize + static_cast<size_t>(width) * height * 2 + sizeof(kQoiEnd));
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    PutBigEndian(out, static_cast<uint32_t>(width));
+    PutBigEndian(out, static_cast<uint32_t>(height));
+    out.push_back(4);   // RGBA
+    out.push_back(0);   // sRGB with linear alpha
+
+    QoiPixel index[64] = {};
+    QoiPixel previous{0, 0, 0, 255};
+    int run = 0;
+    size_t count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < count; ++i)
+    {
+        QoiPixel px{pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2], pixels[i * 4 + 3]};
+        if (std::memcmp(&px, &previous, sizeof(px)) == 0)
+        {
+            if (++run == 62 || i + 1 == count)
+            {
+                out.push_back(kQoiOpRun | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0)
+        {
+            out.push_back(kQoiOpRun | (run - 1));
+            run = 0;
+        }
+
+        int hash = QoiHash(px);
+        if (std::memcmp(&index[hash], &px, sizeof(px)) == 0)
+        {
+            out.push_back(kQoiOpIndex | hash);
+        }
+        else
+        {
+            index[hash] = px;
+            if (px.a == previous.a)
+            {
+                signed char dr = static_cast<signed char>(px.r - previous.r);
+                signed char dg = static_cast<signed char>(px.g - previous.g);
+                signed char db = static_cast<signed char>(px.b - previous.b);
+                signed char drg = static_cast<signed char>(dr - dg);
+                signed char dbg = static_cast<signed char>(db - dg);
+                if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+                {
+                    out.push_back(kQoiOpDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                }
+                else if (drg > -9 && drg < 8 && dg > -33 && dg < 32 && dbg > -9 && dbg < 8)
+                {
+                    out.push_back(kQoiOpLuma | (dg + 32));
+                    out.push_back((drg + 8) << 4 | (dbg + 8));
+                }
+                else
+                {
+                    out.insert(out.end(), {kQoiOpRgb, px.r, px.g, px.b});
+                }
+            }
+            else
+            {
+                out.insert(out.end(), {kQoiOpRgba, px.r, px.g, px.b, px.a});
+            }
+        }
+        previous = px;
+    }
+    out.insert(out.end(), std::begin(kQoiEnd), std::end(kQoiEnd));
+}
+
+/**
+ * Decodes a QOI stream into malloc'd RGBA, null if it is truncated or not 4-channel QOI.
+ */
+static unsigned char *DecodeQoi(const unsigned char *data, size_t size, int &width, int &height)
+{
+    if (size < kQoiHeaderSize + sizeof(kQoiEnd) || std::memcmp(data, "qoif", 4) != 0 || data[12] != 4)
+    {
+        return nullptr;
+    }
+    uint32_t w = GetBigEndian(data + 4);
+    uint32_t h = GetBigEndian(data + 8);
+    if (w == 0 || h == 0 || w > 16384 || h > 16384)
+    {
+        return nullptr;
+    }
+
+    size_t count = static_cast<size_t>(w) * h;
+    unsigned char *pixels = static_cast<unsigned char *>(std::malloc(count * 4));
+    if (!pixels)
+    {
+        return nullptr;
+    }
+    QoiPixel index[64] = {};
+    QoiPixel px{0, 0, 0, 255};
+    size_t pos = kQoiHeaderSize;
+    size_t end = size - sizeof(kQoiEnd);
+    int run = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (run > 0)
+        {
+            --run;
+        }
+        else
+        {
+            if (pos >= end)
+            {
+                std::free(pixels);
+                return nullptr;
+            }
+            unsigned char op = data[pos++];
+            if (op == kQoiOpRgb && pos + 3 <= end)
+            {
+                px.r = data[pos++];
+                px.g = data[pos++];
+                px.b = data[pos++];
+            }
+            else if (op == kQoiOpRgba && pos + 4 <= end)
+            {
+                px.r = data[pos++];
+                px.g = data[pos++];
+                px.b = data[pos++];
+                px.a = data[pos++];
+            }
+            else if ((op & kQoiMask) == kQoiOpIndex)
+            {
+                px = index[op];
+            }
+            else if ((op & kQoiMask) == kQoiOpDiff)
+            {
+                px.r += ((op >> 4) & 0x03) - 2;
+                px.g += ((op >> 2) & 0x03) - 2;
+                px.b += (op & 0x03) - 2;
+            }
+            else if ((op & kQoiMask) == kQoiOpLuma && pos < end)
+            {
+                unsigned char next = data[pos++];
+                int dg = (op & 0x3F) - 32;
+                px.r += dg - 8 + ((next >> 4) & 0x0F);
+                px.g += dg;
+                px.b += dg - 8 + (next & 0x0F);
+            }
+            else if ((op & kQoiMask) == kQoiOpRun && op != kQoiOpRgb && op != kQoiOpRgba)
+            {
+                run = op & 0x3F;
+            }
+            else
+            {
+                std::free(pixels);
+                return nullptr;
+            }
+            index[QoiHash(px)] = px;
+        }
+        std::memcpy(pixels + i * 4, &px, 4);
+    }
+    width = static_cast<int>(w);
+    height = static_cast<int>(h);
+    return pixels;
+}
+
+static std::string CacheKey(const std::string &url, int targetWidth, int targetHeight)
+{
+    return url + "#" + std::to_string(targetWidth) + "x" + std::to_string(targetHeight);
+}
+
+ImageCache::ImageCache(const std::filesystem::path &directory)
+    : directory(directory)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to create image cache directory " << directory << ": " << ec.message() << std::endl;
+    }
+}
+
+unsigned char *ImageCache::Load(const std::string &url, int targetWidth, int targetHeight, int &width, int &height)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::string key = CacheKey(url, targetWidth, targetHeight);
+    MappedFile file;
+    unsigned char *pixels = nullptr;
+    if (file.Open(PathFor(key)))
+    {
+        // the key is stored after the QOI end marker, followed by its length
+        const unsigned char *data = file.Data();
+        size_t size = file.Size();
+        uint32_t keyLength = 0;
+        if (size >= 4)
+        {
+            std::memcpy(&keyLength, data + size - 4, 4);
+        }
+        if (keyLength == key.size() && size >= kQoiHeaderSize + sizeof(kQoiEnd) + keyLength + 4 &&
+            std::memcmp(data + size - 4 - keyLength, key.data(), key.size()) == 0)
+        {
+            pixels = DecodeQoi(data, size - 4 - keyLength, width, height);
+        }
+        if (!pixels)
+        {
+            std::cerr << "Corrupt image cache entry for " << url << std::endl;
+        }
+    }
+
+    if (!pixels)
+    {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    loadMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return pixels;
+}
+
+bool ImageCache::Contains(const std::string &url, int targetWidth, int targetHeight) const
+{
+    std::error_code ec;
+    return std::filesystem::exists(PathFor(CacheKey(url, targetWidth, targetHeight)), ec);
+}
+
+bool ImageCache::Store(const std::string &url, int targetWidth, int targetHeight, const unsigned char *pixels, int width, int height)
+{
+    std::string key = CacheKey(url, targetWidth, targetHeight);
+    std::vector<unsigned char> encoded;
+    EncodeQoi(pixels, width, height, encoded);
+    encoded.insert(encoded.end(), key.begin(), key.end());
+    uint32_t keyLength = static_cast<uint32_t>(key.size());
+    encoded.insert(encoded.end(), reinterpret_cast<const unsigned char *>(&keyLength), reinterpret_cast<const unsigned char *>(&keyLength) + 4);
+
+    // Write to a temporary file and rename, so readers never map a partial image
+    std::lock_guard<std::mutex> lock(storeMutex);
+    auto path = PathFor(key);
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(encoded.data()), encoded.size());
+        if (!file)
+        {
+            std::cerr << "Failed to write image cache entry for " << url << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to store image cache entry for " << url << ": " << ec.message() << std::endl;
+        return false;
+    }
+    stored++;
+    return true;
+}
+
+ImageCache::Stats ImageCache::GetStats() const
+{
+    Stats stats;
+    stats.hits = hits.load();
+    stats.misses = misses.load();
+    stats.stored = stored.load();
+    stats.loadMs = loadMicroseconds.load() / 1000.0;
+    return stats;
+}
+
+std::filesystem::path ImageCache::PathFor(const std::string &key) const
+{
+    return directory / (HttpCache::HashUrl(key) + ".qoi");
+}
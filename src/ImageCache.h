@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+/**
+ * @brief 디코딩이 끝난 RGBA 이미지를 QOI 로 저장해 두는 디스크 캐시
+ *
+ * Keyed by URL and decode size, so a skin thumbnail and the full splash of
+ * the same image are separate entries. Files are plain QOI, lossless and
+ * several times faster to decode than JPEG or PNG. They are memory-mapped
+ * and decoded in place. The key follows the QOI end marker to rule out hash
+ * collisions. Images never expire: their URLs carry the patch version, and
+ * splashes change rarely enough that deleting the directory will do.
+ *
+ * Load() and Store() may be called from any thread.
+ */
+class ImageCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t stored = 0;
+        double loadMs = 0.0;        // mapping and decoding hits, summed over threads
+    };
+
+    explicit ImageCache(const std::filesystem::path& directory);
+
+    /**
+     * @brief RGBA pixels stored for url at the target size, null when there are none. Free with FreeImagePixels().
+     */
+    unsigned char* Load(const std::string& url, int targetWidth, int targetHeight, int& width, int& height);
+
+    bool Contains(const std::string& url, int targetWidth, int targetHeight) const;
+
+    bool Store(const std::string& url, int targetWidth, int targetHeight, const unsigned char* pixels, int width, int height);
+
+    Stats GetStats() const;
+
+private:
+    std::filesystem::path PathFor(const std::string& key) const;
+
+    std::filesystem::path directory;
+    std::mutex storeMutex;
+
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    std::atomic<size_t> stored{0};
+    std::atomic<uint64_t> loadMicroseconds{0};
+};
@@ -0,0 +1,100 @@
+#include "ImageDecoder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <stb_image.h>
+#include <turbojpeg.h>
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include <stb_image_resize2.h>
+
+static bool IsJpeg(const unsigned char *data, size_t size)
+{
+    return size > 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+/**
+ * Decodes a JPEG at the smallest DCT scaling factor whose result still covers the target, full size without one.
+ */
+static unsigned char *DecodeJpeg(const unsigned char *data, size_t size, int targetWidth, int targetHeight, int &width, int &height)
+{
+    tjhandle decoder = tjInitDecompress();
+    if (!decoder)
+    {
+        return nullptr;
+    }
+
+    unsigned char *pixels = nullptr;
+    int fullWidth = 0, fullHeight = 0, subsampling = 0, colorspace = 0;
+    if (tjDecompressHeader3(decoder, data, static_cast<unsigned long>(size), &fullWidth, &fullHeight, &subsampling, &colorspace) == 0)
+    {
+        width = fullWidth;
+        height = fullHeight;
+        if (targetWidth > 0 && targetHeight > 0)
+        {
+            int count = 0;
+            const tjscalingfactor *factors = tjGetScalingFactors(&count);
+            for (int i = 0; i < count; ++i)
+            {
+                int scaledWidth = TJSCALED(fullWidth, factors[i]);
+                int scaledHeight = TJSCALED(fullHeight, factors[i]);
+                if (scaledWidth >= std::min(targetWidth, fullWidth) && scaledHeight >= std::min(targetHeight, fullHeight) &&
+                    scaledWidth * scaledHeight < width * height)
+                {
+                    width = scaledWidth;
+                    height = scaledHeight;
+                }
+            }
+        }
+
+        pixels = static_cast<unsigned char *>(std::malloc(static_cast<size_t>(width) * height * 4));
+        if (pixels && tjDecompress2(decoder, data, static_cast<unsigned long>(size), pixels, width, width * 4, height, TJPF_RGBA, TJFLAG_FASTDCT) != 0)
+        {
+            std::cerr << "JPEG decode failed: " << tjGetErrorStr2(decoder) << std::endl;
+            std::free(pixels);
+            pixels = nullptr;
+        }
+    }
+    tjDestroy(decoder);
+    return pixels;
+}
+
+unsigned char *DecodeImage(const unsigned char *data, size_t size, int targetWidth, int targetHeight, int &width, int &height)
+{
+    unsigned char *pixels = nullptr;
+    if (IsJpeg(data, size))
+    {
+        pixels = DecodeJpeg(data, size, targetWidth, targetHeight, width, height);
+    }
+    if (!pixels)
+    {
+        // stbi allocates with malloc, so its pixels are freed like ours
+        int channels = 0;
+        pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+    }
+    if (!pixels || targetWidth <= 0 || targetHeight <= 0)
+    {
+        return pixels;
+    }
+
+    int outputWidth = std::min(targetWidth, width);
+    int outputHeight = std::min(targetHeight, height);
+    if (outputWidth == width && outputHeight == height)
+    {
+        return pixels;
+    }
+    unsigned char *resized = static_cast<unsigned char *>(std::malloc(static_cast<size_t>(outputWidth) * outputHeight * 4));
+    if (!resized || !stbir_resize_uint8_srgb(pixels, width, height, width * 4, resized, outputWidth, outputHeight, outputWidth * 4, STBIR_RGBA))
+    {
+        std::free(resized);
+        return pixels;  // drawn scaled by the GPU instead
+    }
+    std::free(pixels);
+    width = outputWidth;
+    height = outputHeight;
+    return resized;
+}
+
+void FreeImagePixels(unsigned char *pixels)
+{
+    std::free(pixels);
+}
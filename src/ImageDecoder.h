@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief 그려질 크기에 맞춰 이미지를 RGBA로 디코딩하는 함수
+ *
+ * JPEGs are decoded by libjpeg-turbo, scaled in the DCT domain to the smallest
+ * of its 1/8 steps still covering the target, so a splash shown as a thumbnail
+ * never has its full resolution reconstructed. Whatever is left, and every
+ * other format, is resampled with stb_image_resize2, which uses SIMD.
+ * Safe to call from any thread.
+ */
+
+/**
+ * Decodes to RGBA at targetWidth x targetHeight, or at full size when either is 0.
+ * Images are only ever shrunk: a target larger than the image keeps the image's
+ * size on that axis. Returns null on failure; free the pixels with FreeImagePixels().
+ */
+unsigned char* DecodeImage(const unsigned char* data, size_t size, int targetWidth, int targetHeight, int& width, int& height);
+
+void FreeImagePixels(unsigned char* pixels);
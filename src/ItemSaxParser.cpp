@@ -0,0 +1,224 @@
+#include "ItemSaxParser.h"
+
+ItemSaxParser::ItemSaxParser(std::vector<SnapshotBuilder::Item> &items)
+    : items(items)
+{
+    // nothing
+}
+
+bool ItemSaxParser::Parse(std::istream &input, std::vector<SnapshotBuilder::Item> &items, std::string &error)
+{
+    ItemSaxParser parser(items);
+    if (!nlohmann::json::sax_parse(input, &parser))
+    {
+        error = parser.error.empty() ? "unexpected document structure" : parser.error;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * True when the current path inside an item is exactly a / b / c.
+ */
+bool ItemSaxParser::At(const char *a, const char *b, const char *c) const
+{
+    size_t length = 2 + (b ? 1 : 0) + (c ? 1 : 0);
+    return depth == length && path[1] == a && (!b || path[2] == b) && (!c || path[3] == c);
+}
+
+bool ItemSaxParser::null()
+{
+    return true;
+}
+
+bool ItemSaxParser::boolean(bool value)
+{
+    if (At("shop", "purchasable"))
+    {
+        item.purchasable = value;
+    }
+    return true;
+}
+
+bool ItemSaxParser::number_integer(number_integer_t value)
+{
+    Number(static_cast<double>(value), std::to_string(value));
+    return true;
+}
+
+bool ItemSaxParser::number_unsigned(number_unsigned_t value)
+{
+    Number(static_cast<double>(value), std::to_string(value));
+    return true;
+}
+
+bool ItemSaxParser::number_float(number_float_t value, const string_t &text)
+{
+    Number(value, text);
+    return true;
+}
+
+bool ItemSaxParser::string(string_t &value)
+{
+    Text(value);
+    return true;
+}
+
+bool ItemSaxParser::binary(binary_t &)
+{
+    return true;
+}
+
+bool ItemSaxParser::start_object(std::size_t)
+{
+    if (depth == 1)
+    {
+        item = SnapshotBuilder::Item();
+        item.id = path[0];
+    }
+    else if (depth == 3 && path[1] == "stats")
+    {
+        stat = SnapshotBuilder::ItemStat();
+        stat.name = path[2];
+    }
+    else if (At("active", "[]"))
+    {
+        active = SnapshotBuilder::ItemActive();
+    }
+
+    if (depth == path.size())
+    {
+        path.emplace_back();
+    }
+    path[depth++].clear();
+    return true;
+}
+
+bool ItemSaxParser::key(string_t &value)
+{
+    path[depth - 1] = value;
+    return true;
+}
+
+bool ItemSaxParser::end_object()
+{
+    --depth;
+    if (depth == 1)
+    {
+        items.push_back(std::move(item));
+    }
+    else if (depth == 3 && path[1] == "stats")
+    {
+        if (stat.flat != 0 || stat.percent != 0)
+        {
+            item.stats.push_back(std::move(stat));
+        }
+    }
+    else if (At("active", "[]"))
+    {
+        item.actives.push_back(std::move(active));
+    }
+    return true;
+}
+
+bool ItemSaxParser::start_array(std::size_t)
+{
+    if (depth == 0)
+    {
+        error = "items.json is not an object of items";
+        return false;
+    }
+    if (depth == path.size())
+    {
+        path.emplace_back();
+    }
+    path[depth++] = "[]";
+    return true;
+}
+
+bool ItemSaxParser::end_array()
+{
+    --depth;
+    return true;
+}
+
+bool ItemSaxParser::parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex)
+{
+    error = ex.what();
+    return false;
+}
+
+void ItemSaxParser::Number(double value, const std::string &text)
+{
+    if (At("shop", "prices", "total"))
+    {
+        item.cost = static_cast<int>(value);
+    }
+    else if (At("shop", "prices", "sell"))
+    {
+        item.sell = static_cast<int>(value);
+    }
+    else if (depth == 4 && path[1] == "stats")
+    {
+        if (path[3] == "flat")
+        {
+            stat.flat = static_cast<float>(value);
+        }
+        else if (path[3] == "percent")
+        {
+            stat.percent = static_cast<float>(value);
+        }
+    }
+    else if (At("buildsFrom", "[]") || At("buildsInto", "[]") || (depth == 4 && path[1] == "active" && path[2] == "[]"))
+    {
+        // ids in buildsFrom / buildsInto and active cooldowns are sometimes numbers
+        std::string copy = text;
+        Text(copy);
+    }
+}
+
+void ItemSaxParser::Text(std::string &value)
+{
+    if (depth == 2)
+    {
+        if (path[1] == "name")
+        {
+            item.name = std::move(value);
+        }
+        else if (path[1] == "icon")
+        {
+            item.icon = std::move(value);
+        }
+        else if (path[1] == "simpleDescription")
+        {
+            item.description = std::move(value);
+        }
+    }
+    else if (At("buildsFrom", "[]"))
+    {
+        item.buildsFrom.push_back(std::move(value));
+    }
+    else if (At("buildsInto", "[]"))
+    {
+        item.buildsInto.push_back(std::move(value));
+    }
+    else if (At("shop", "tags", "[]"))
+    {
+        item.tags.push_back(std::move(value));
+    }
+    else if (depth == 4 && path[1] == "active" && path[2] == "[]")
+    {
+        if (path[3] == "name")
+        {
+            active.name = std::move(value);
+        }
+        else if (path[3] == "effects")
+        {
+            active.effects = std::move(value);
+        }
+        else if (path[3] == "cooldown")
+        {
+            active.cooldown = std::move(value);
+        }
+    }
+}
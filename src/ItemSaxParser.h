@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <nlohmann/json.hpp>
+#include "Snapshot.h"
+
+/**
+ * @brief merakianalytics items.json 를 DOM 없이 아이템 레코드로 읽는 SAX 파서
+ *
+ * Only the fields the app uses are kept. Everything else is skipped as it is
+ * read, so memory stays proportional to the records rather than to the document.
+ */
+class ItemSaxParser : public nlohmann::json_sax<nlohmann::json> {
+public:
+    /**
+     * @brief Parses the whole input, which may be a stream that is still being written.
+     */
+    static bool Parse(std::istream& input, std::vector<SnapshotBuilder::Item>& items, std::string& error);
+
+    bool null() override;
+    bool boolean(bool value) override;
+    bool number_integer(number_integer_t value) override;
+    bool number_unsigned(number_unsigned_t value) override;
+    bool number_float(number_float_t value, const string_t& text) override;
+    bool string(string_t& value) override;
+    bool binary(binary_t& value) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& value) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex) override;
+
+private:
+    explicit ItemSaxParser(std::vector<SnapshotBuilder::Item>& items);
+
+    void Number(double value, const std::string& text);
+    void Text(std::string& value);
+    bool At(const char* a, const char* b = nullptr, const char* c = nullptr) const;
+
+    std::vector<SnapshotBuilder::Item>& items;
+    std::vector<std::string> path;   // object keys, "[]" for array elements, path[0] is the item id
+    size_t depth = 0;                // number of used entries in path, the strings are reused
+    SnapshotBuilder::Item item;
+    SnapshotBuilder::ItemStat stat;
+    SnapshotBuilder::ItemActive active;
+    std::string error;
+};
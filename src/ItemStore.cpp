@@ -0,0 +1,238 @@
+#include "ItemStore.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+template <typename T>
+Span<T> ItemStore::Adjacent(const std::vector<uint32_t> &offsets, const std::vector<T> &values, ItemHandle item)
+{
+    return Span<T>{values.data() + offsets[item], values.data() + offsets[item + 1]};
+}
+
+void ItemStore::Clear()
+{
+    *this = ItemStore();
+}
+
+void ItemStore::Build(const Snapshot &snapshot)
+{
+    Clear();
+    auto items = snapshot.Items();
+    const size_t count = items.size();
+
+    ids.reserve(count);
+    names.reserve(count);
+    iconUrls.reserve(count);
+    descriptions.reserve(count);
+    costs.reserve(count);
+    sellPrices.reserve(count);
+    purchasable.reserve(count);
+    tagMasks.reserve(count);
+    idIndex.reserve(count);
+    nameIndex.reserve(count);
+    iconUrlIndex.reserve(count);
+    for (const auto &item : items)
+    {
+        ItemHandle handle = static_cast<ItemHandle>(ids.size());
+        idIndex.emplace(snapshot.Str(item.id), handle);
+        nameIndex[snapshot.Str(item.name)] = handle;
+        iconUrlIndex.emplace(snapshot.Str(item.icon), handle);
+        ids.push_back(snapshot.CStr(item.id));
+        names.push_back(snapshot.CStr(item.name));
+        iconUrls.push_back(snapshot.CStr(item.icon));
+        descriptions.push_back(item.description.length > 0 ? snapshot.CStr(item.description) : kMissingDescription);
+        costs.push_back(item.cost);
+        sellPrices.push_back(item.sell);
+        purchasable.push_back(item.purchasable != 0 ? 1 : 0);
+
+        uint64_t mask = 0;
+        for (const auto &tag : snapshot.Strings(item.tags))
+        {
+            std::string_view name = snapshot.Str(tag);
+            auto it = std::find(tagNames.begin(), tagNames.end(), name);
+            if (it == tagNames.end())
+            {
+                if (tagNames.size() == kMaxTags)
+                {
+                    std::cerr << "Too many item tags, ignoring " << name << std::endl;
+                    continue;
+                }
+                it = tagNames.emplace(tagNames.end(), name);
+            }
+            mask |= uint64_t(1) << (it - tagNames.begin());
+        }
+        tagMasks.push_back(mask);
+
+        for (const auto &stat : snapshot.ItemStats(item.stats))
+        {
+            std::string_view name = snapshot.Str(stat.name);
+            if (std::find(statNames.begin(), statNames.end(), name) == statNames.end())
+            {
+                statNames.emplace_back(name);
+            }
+        }
+    }
+
+    // Inverted tag index; walking the items in handle order keeps every list sorted
+    tagOffsets.assign(tagNames.size() + 1, 0);
+    for (uint64_t mask : tagMasks)
+    {
+        for (size_t tag = 0; tag < tagNames.size(); ++tag)
+        {
+            tagOffsets[tag + 1] += (mask >> tag) & 1;
+        }
+    }
+    for (size_t tag = 0; tag < tagNames.size(); ++tag)
+    {
+        tagOffsets[tag + 1] += tagOffsets[tag];
+    }
+    taggedItems.resize(tagOffsets.back());
+    std::vector<uint32_t> next(tagOffsets.begin(), tagOffsets.end() - 1);
+    for (ItemHandle item = 0; item < count; ++item)
+    {
+        for (size_t tag = 0; tag < tagNames.size(); ++tag)
+        {
+            if ((tagMasks[item] >> tag) & 1)
+            {
+                taggedItems[next[tag]++] = item;
+            }
+        }
+    }
+
+    // Second pass once every column name is known
+    const size_t statCount = statNames.size();
+    flatStats.assign(count * statCount, 0.0f);
+    percentStats.assign(count * statCount, 0.0f);
+    buildsFromOffsets.reserve(count + 1);
+    buildsIntoOffsets.reserve(count + 1);
+    activeOffsets.reserve(count + 1);
+    buildsFromOffsets.push_back(0);
+    buildsIntoOffsets.push_back(0);
+    activeOffsets.push_back(0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SnapshotItem &item = items[i];
+        for (const auto &stat : snapshot.ItemStats(item.stats))
+        {
+            size_t column = std::find(statNames.begin(), statNames.end(), snapshot.Str(stat.name)) - statNames.begin();
+            flatStats[i * statCount + column] = stat.flat;
+            percentStats[i * statCount + column] = stat.percent;
+        }
+
+        // Recipe ids that are not in the catalogue are dropped here rather than checked on every draw
+        for (const auto &id : snapshot.Strings(item.buildsFrom))
+        {
+            ItemHandle handle = Find(snapshot.Str(id));
+            if (handle != kInvalidItem)
+            {
+                buildsFrom.push_back(handle);
+            }
+        }
+        buildsFromOffsets.push_back(static_cast<uint32_t>(buildsFrom.size()));
+        for (const auto &id : snapshot.Strings(item.buildsInto))
+        {
+            ItemHandle handle = Find(snapshot.Str(id));
+            if (handle != kInvalidItem)
+            {
+                buildsInto.push_back(handle);
+            }
+        }
+        buildsIntoOffsets.push_back(static_cast<uint32_t>(buildsInto.size()));
+
+        for (const auto &active : snapshot.ItemActives(item.actives))
+        {
+            actives.push_back({snapshot.CStr(active.name), snapshot.CStr(active.effects), snapshot.CStr(active.cooldown)});
+        }
+        activeOffsets.push_back(static_cast<uint32_t>(actives.size()));
+    }
+}
+
+ItemHandle ItemStore::Lookup(const ReverseIndex &index, std::string_view key)
+{
+    auto it = index.find(key);
+    return it != index.end() ? it->second : kInvalidItem;
+}
+
+size_t ItemStore::TagIndex(std::string_view tag) const
+{
+    return std::find(tagNames.begin(), tagNames.end(), tag) - tagNames.begin();
+}
+
+uint64_t ItemStore::TagBit(std::string_view tag) const
+{
+    size_t index = TagIndex(tag);
+    return index < tagNames.size() ? uint64_t(1) << index : 0;
+}
+
+Span<ItemHandle> ItemStore::ItemsWithTag(std::string_view tag) const
+{
+    size_t index = TagIndex(tag);
+    if (index >= tagNames.size())
+    {
+        return Span<ItemHandle>();
+    }
+    return Adjacent(tagOffsets, taggedItems, static_cast<ItemHandle>(index));
+}
+
+/**
+ * Intersects the posting lists, smallest first, so the work is bounded by the rarest tag.
+ */
+std::vector<ItemHandle> ItemStore::ItemsWithAllTags(const std::vector<std::string> &tags) const
+{
+    std::vector<Span<ItemHandle>> lists;
+    for (const auto &tag : tags)
+    {
+        lists.push_back(ItemsWithTag(tag));
+    }
+    if (lists.empty())
+    {
+        return {};
+    }
+    std::sort(lists.begin(), lists.end(), [](const Span<ItemHandle> &a, const Span<ItemHandle> &b)
+              { return a.size() < b.size(); });
+
+    std::vector<ItemHandle> result(lists[0].begin(), lists[0].end());
+    std::vector<ItemHandle> scratch;
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i)
+    {
+        scratch.clear();
+        std::set_intersection(result.begin(), result.end(), lists[i].begin(), lists[i].end(), std::back_inserter(scratch));
+        result.swap(scratch);
+    }
+    return result;
+}
+
+std::vector<ItemHandle> ItemStore::ItemsWithAnyTag(const std::vector<std::string> &tags) const
+{
+    std::vector<ItemHandle> result;
+    std::vector<ItemHandle> scratch;
+    for (const auto &tag : tags)
+    {
+        Span<ItemHandle> list = ItemsWithTag(tag);
+        scratch.clear();
+        std::set_union(result.begin(), result.end(), list.begin(), list.end(), std::back_inserter(scratch));
+        result.swap(scratch);
+    }
+    return result;
+}
+
+Span<float> ItemStore::Row(const std::vector<float> &matrix, ItemHandle item) const
+{
+    const float *row = matrix.data() + static_cast<size_t>(item) * statNames.size();
+    return Span<float>{row, row + statNames.size()};
+}
+
+Span<ItemHandle> ItemStore::BuildsFrom(ItemHandle item) const
+{
+    return Adjacent(buildsFromOffsets, buildsFrom, item);
+}
+
+Span<ItemHandle> ItemStore::BuildsInto(ItemHandle item) const
+{
+    return Adjacent(buildsIntoOffsets, buildsInto, item);
+}
+
+Span<ItemStore::Active> ItemStore::Actives(ItemHandle item) const
+{
+    return Adjacent(activeOffsets, actives, item);
+}
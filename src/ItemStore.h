@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Snapshot.h"
+#include "Span.h"
+
+/**
+ * Dense index of an item in ItemStore, equal to its position in the snapshot.
+ */
+using ItemHandle = uint32_t;
+constexpr ItemHandle kInvalidItem = UINT32_MAX;
+
+/**
+ * @brief 아이템 데이터를 열(column) 단위 배열로 보관하는 저장소
+ *
+ * Every per-item field is a flat array indexed by ItemHandle, so drawing the
+ * item grid and the detail panel only reads arrays. Text columns point into the
+ * snapshot blob and stay valid until the store is rebuilt. Stats form a matrix
+ * of one row per item and one column per stat name, tags are a bitmask per item
+ * plus an inverted index from each tag to its items, and the recipe graph is
+ * kept as compressed adjacency lists of handles.
+ */
+class ItemStore {
+public:
+    struct Active {
+        const char* name;
+        const char* effects;
+        const char* cooldown;
+    };
+    static constexpr size_t kMaxTags = 64;
+    static constexpr const char* kMissingDescription = "No description available";
+
+    void Build(const Snapshot& snapshot);
+    void Clear();
+
+    size_t Size() const { return ids.size(); }
+    ItemHandle Find(std::string_view id) const { return Lookup(idIndex, id); }
+    ItemHandle FindByName(std::string_view name) const { return Lookup(nameIndex, name); }
+    ItemHandle FindByIconUrl(std::string_view url) const { return Lookup(iconUrlIndex, url); }
+
+    const char* Id(ItemHandle item) const { return ids[item]; }
+    const char* Name(ItemHandle item) const { return names[item]; }
+    const char* IconUrl(ItemHandle item) const { return iconUrls[item]; }
+    const char* Description(ItemHandle item) const { return descriptions[item]; }
+    bool HasDescription(ItemHandle item) const { return descriptions[item] != kMissingDescription; }
+    int Cost(ItemHandle item) const { return costs[item]; }
+    int SellPrice(ItemHandle item) const { return sellPrices[item]; }
+    bool Purchasable(ItemHandle item) const { return purchasable[item] != 0; }
+
+    uint64_t TagMask(ItemHandle item) const { return tagMasks[item]; }
+    uint64_t TagBit(std::string_view tag) const;
+    const std::vector<std::string>& TagNames() const { return tagNames; }
+
+    /**
+     * Items carrying a tag, in ascending handle (and therefore id) order.
+     */
+    Span<ItemHandle> ItemsWithTag(std::string_view tag) const;
+    std::vector<ItemHandle> ItemsWithAllTags(const std::vector<std::string>& tags) const;
+    std::vector<ItemHandle> ItemsWithAnyTag(const std::vector<std::string>& tags) const;
+
+    /**
+     * Stat values of one item, parallel to StatNames(). Stats the item lacks are 0.
+     */
+    Span<float> FlatStats(ItemHandle item) const { return Row(flatStats, item); }
+    Span<float> PercentStats(ItemHandle item) const { return Row(percentStats, item); }
+    const std::vector<std::string>& StatNames() const { return statNames; }
+
+    Span<ItemHandle> BuildsFrom(ItemHandle item) const;
+    Span<ItemHandle> BuildsInto(ItemHandle item) const;
+    Span<Active> Actives(ItemHandle item) const;
+
+private:
+    Span<float> Row(const std::vector<float>& matrix, ItemHandle item) const;
+    size_t TagIndex(std::string_view tag) const;
+    using ReverseIndex = std::unordered_map<std::string_view, ItemHandle>;
+    static ItemHandle Lookup(const ReverseIndex& index, std::string_view key);
+    template <typename T>
+    static Span<T> Adjacent(const std::vector<uint32_t>& offsets, const std::vector<T>& values, ItemHandle item);
+
+    std::vector<const char*> ids;           // sorted, as in the snapshot
+    std::vector<const char*> names;
+    std::vector<const char*> iconUrls;
+    std::vector<const char*> descriptions;
+    // Keys view the snapshot blob, like the columns above
+    ReverseIndex idIndex;
+    ReverseIndex nameIndex;                 // the last item wins when names repeat
+    ReverseIndex iconUrlIndex;
+    std::vector<int32_t> costs;             // -1 when unknown
+    std::vector<int32_t> sellPrices;        // -1 when unknown
+    std::vector<uint8_t> purchasable;
+
+    std::vector<std::string> tagNames;      // bit i of a tag mask is tagNames[i]
+    std::vector<uint64_t> tagMasks;
+    std::vector<uint32_t> tagOffsets;       // inverted index: items with tag i are taggedItems[tagOffsets[i] .. tagOffsets[i + 1]]
+    std::vector<ItemHandle> taggedItems;
+
+    std::vector<std::string> statNames;
+    std::vector<float> flatStats;           // Size() x statNames.size()
+    std::vector<float> percentStats;
+
+    // Compressed adjacency: the neighbours of item i are values[offsets[i] .. offsets[i + 1]]
+    std::vector<uint32_t> buildsFromOffsets;
+    std::vector<ItemHandle> buildsFrom;
+    std::vector<uint32_t> buildsIntoOffsets;
+    std::vector<ItemHandle> buildsInto;
+    std::vector<uint32_t> activeOffsets;
+    std::vector<Active> actives;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+/**
+ * @brief 읽기 전용 메모리 맵 파일
+ *
+ * Maps a whole file into the address space so callers can read it in place.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+    const unsigned char* data;
+    size_t size;
+};
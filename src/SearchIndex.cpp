@@ -0,0 +1,360 @@
+#include "SearchIndex.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <atomic>
+
+static std::atomic<uint32_t> nextRevision{1};
+
+/**
+ * Simple case folding for the scripts that appear in the Data Dragon locales:
+ * Latin, Greek, Cyrillic and full-width Latin. Other code points fold to themselves.
+ */
+static uint32_t FoldCodepoint(uint32_t c)
+{
+    if ((c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7) ||
+        (c >= 0x391 && c <= 0x3AB && c != 0x3A2) || (c >= 0x410 && c <= 0x42F) || (c >= 0xFF21 && c <= 0xFF3A))
+    {
+        return c + 0x20;
+    }
+    if (c >= 0x400 && c <= 0x40F)
+    {
+        return c + 0x50;
+    }
+    if (c == 0x178)
+    {
+        return 0xFF;
+    }
+    // Latin Extended-A alternates upper and lower case, with the parity flipping at U+0139 and U+014A
+    if ((c >= 0x100 && c <= 0x137 && c != 0x130 && c % 2 == 0) || (c >= 0x139 && c <= 0x148 && c % 2 == 1) ||
+        (c >= 0x14A && c <= 0x177 && c % 2 == 0) || (c >= 0x179 && c <= 0x17E && c % 2 == 1))
+    {
+        return c + 1;
+    }
+    return c;
+}
+
+std::string SearchIndex::Fold(std::string_view text)
+{
+    std::string folded;
+    folded.reserve(text.size());
+    for (size_t pos = 0; pos < text.size();)
+    {
+        uint32_t codepoint = 0;
+        size_t length = DecodeUtf8(text, pos, codepoint);
+        if (length == 0)
+        {
+            folded += text[pos++];  // keep malformed bytes as they are
+            continue;
+        }
+        AppendUtf8(folded, FoldCodepoint(codepoint));
+        pos += length;
+    }
+    return folded;
+}
+
+std::string SearchIndex::Chosung(std::string_view folded)
+{
+    // Compatibility jamo for the 19 initial consonants, in syllable order
+    static const uint32_t initials[19] = {
+        0x3131, 0x3132, 0x3134, 0x3137, 0x3138, 0x3139, 0x3141, 0x3142, 0x3143, 0x3145,
+        0x3146, 0x3147, 0x3148, 0x3149, 0x314A, 0x314B, 0x314C, 0x314D, 0x314E};
+    const uint32_t firstSyllable = 0xAC00, lastSyllable = 0xD7A3, syllablesPerInitial = 21 * 28;
+
+    std::string key;
+    key.reserve(folded.size());
+    for (size_t pos = 0; pos < folded.size();)
+    {
+        uint32_t codepoint = 0;
+        size_t length = DecodeUtf8(folded, pos, codepoint);
+        if (length == 0)
+        {
+            key += folded[pos++];
+            continue;
+        }
+        if (codepoint >= firstSyllable && codepoint <= lastSyllable)
+        {
+            codepoint = initials[(codepoint - firstSyllable) / syllablesPerInitial];
+        }
+        AppendUtf8(key, codepoint);
+        pos += length;
+    }
+    return key;
+}
+
+void SearchIndex::Build(const std::vector<std::string> &names)
+{
+    revision = nextRevision++;
+    keys.clear();
+    keyOffsets.assign(1, 0);
+    chosungKeys.clear();
+    chosungOffsets.assign(1, 0);
+    bigrams.clear();
+    alphabet.clear();
+    symbols.clear();
+    symbolOffsets.assign(1, 0);
+    for (uint32_t entry = 0; entry < names.size(); ++entry)
+    {
+        std::string key = Fold(names[entry]);
+        std::string chosung = Chosung(key);
+        AddBigrams(entry, key);
+        AddSymbols(key);
+        keys += key;
+        keyOffsets.push_back(static_cast<uint32_t>(keys.size()));
+
+        // Names without Hangul have no separate chosung key
+        if (chosung != key)
+        {
+            AddBigrams(entry, chosung);
+            AddSymbols(chosung);
+            chosungKeys += chosung;
+        }
+        else
+        {
+            AddSymbols(std::string_view());
+        }
+        chosungOffsets.push_back(static_cast<uint32_t>(chosungKeys.size()));
+    }
+    std::sort(bigrams.begin(), bigrams.end());
+    bigrams.erase(std::unique(bigrams.begin(), bigrams.end()), bigrams.end());
+}
+
+void SearchIndex::AddBigrams(uint32_t entry, std::string_view key)
+{
+    for (size_t i = 1; i < key.size(); ++i)
+    {
+        uint64_t gram = Bigram(static_cast<unsigned char>(key[i - 1]), static_cast<unsigned char>(key[i]));
+        bigrams.push_back((gram << 32) | entry);
+    }
+}
+
+void SearchIndex::AddSymbols(std::string_view key)
+{
+    for (size_t pos = 0; pos < key.size();)
+    {
+        uint32_t codepoint = 0;
+        size_t length = DecodeUtf8(key, pos, codepoint);
+        if (length == 0)
+        {
+            codepoint = static_cast<unsigned char>(key[pos]);
+            length = 1;
+        }
+        auto it = alphabet.find(codepoint);
+        if (it == alphabet.end())
+        {
+            if (alphabet.size() == UINT16_MAX)
+            {
+                pos += length;
+                continue;
+            }
+            it = alphabet.emplace(codepoint, static_cast<uint16_t>(alphabet.size())).first;
+        }
+        symbols.push_back(it->second);
+        pos += length;
+    }
+    symbolOffsets.push_back(static_cast<uint32_t>(symbols.size()));
+}
+
+std::string_view SearchIndex::Key(uint32_t entry) const
+{
+    return std::string_view(keys).substr(keyOffsets[entry], keyOffsets[entry + 1] - keyOffsets[entry]);
+}
+
+std::string_view SearchIndex::ChosungKey(uint32_t entry) const
+{
+    return std::string_view(chosungKeys).substr(chosungOffsets[entry], chosungOffsets[entry + 1] - chosungOffsets[entry]);
+}
+
+bool SearchIndex::Contains(uint32_t entry, std::string_view key) const
+{
+    if (Key(entry).find(key) != std::string_view::npos)
+    {
+        return true;
+    }
+    std::string_view chosung = ChosungKey(entry);
+    return !chosung.empty() && chosung.find(key) != std::string_view::npos;
+}
+
+void SearchIndex::Search(std::string_view key, std::vector<uint32_t> &out) const
+{
+    out.clear();
+    if (key.size() < 2)
+    {
+        for (uint32_t entry = 0; entry < Size(); ++entry)
+        {
+            if (Contains(entry, key))
+            {
+                out.push_back(entry);
+            }
+        }
+        return;
+    }
+
+    // Candidates are the entries holding the query's rarest bigram
+    auto first = bigrams.end();
+    auto last = bigrams.end();
+    for (size_t i = 1; i < key.size(); ++i)
+    {
+        uint64_t gram = Bigram(static_cast<unsigned char>(key[i - 1]), static_cast<unsigned char>(key[i]));
+        auto lower = std::lower_bound(bigrams.begin(), bigrams.end(), gram << 32);
+        auto upper = std::lower_bound(lower, bigrams.end(), (gram + 1) << 32);
+        if (i == 1 || upper - lower < last - first)
+        {
+            first = lower;
+            last = upper;
+        }
+        if (first == last)
+        {
+            return;
+        }
+    }
+    for (auto it = first; it != last; ++it)
+    {
+        uint32_t entry = static_cast<uint32_t>(*it);
+        if (Contains(entry, key))
+        {
+            out.push_back(entry);
+        }
+    }
+}
+
+uint32_t SearchIndex::MaxErrors(size_t queryLength)
+{
+    return queryLength < 3 ? 0 : queryLength < 6 ? 1 : 2;
+}
+
+/**
+ * Fewest insertions, deletions, substitutions and adjacent swaps that turn the
+ * pattern into some substring of the text. Bit j of peq[symbol] is set when
+ * pattern position j is that symbol; the pattern is at most 64 long and each
+ * text symbol costs a handful of word operations (Myers 1999, with Hyyro's
+ * transposition term).
+ */
+static uint32_t SubstringDistance(const std::vector<uint64_t> &peq, size_t patternLength, const uint16_t *text, size_t textLength)
+{
+    const uint64_t lastBit = uint64_t(1) << (patternLength - 1);
+    uint64_t vp = ~uint64_t(0), vn = 0, d0 = 0, previousMatch = 0;
+    uint32_t score = static_cast<uint32_t>(patternLength);
+    uint32_t best = score;
+    for (size_t i = 0; i < textLength; ++i)
+    {
+        uint64_t match = peq[text[i]];
+        uint64_t swap = ((~d0 & match) << 1) & previousMatch;
+        d0 = (((match & vp) + vp) ^ vp) | match | vn | swap;
+        uint64_t hp = vn | ~(d0 | vp);
+        uint64_t hn = vp & d0;
+        if (hp & lastBit)
+        {
+            ++score;
+        }
+        else if (hn & lastBit)
+        {
+            --score;
+        }
+        // No carry into the first row: the match may start anywhere in the text
+        uint64_t x = hp << 1;
+        vn = x & d0;
+        vp = (hn << 1) | ~(x | d0);
+        previousMatch = match;
+        best = std::min(best, score);
+    }
+    return best;
+}
+
+std::vector<SearchIndex::FuzzyMatch> SearchIndex::FuzzySearch(std::string_view query, size_t limit) const
+{
+    std::vector<FuzzyMatch> results;
+    std::string key = Fold(query);
+    std::vector<uint64_t> peq(alphabet.size(), 0);
+    size_t patternLength = 0;
+    for (size_t pos = 0; pos < key.size() && patternLength < 64; ++patternLength)
+    {
+        uint32_t codepoint = 0;
+        size_t length = DecodeUtf8(key, pos, codepoint);
+        if (length == 0)
+        {
+            codepoint = static_cast<unsigned char>(key[pos]);
+            length = 1;
+        }
+        // A code point no name uses gets no bit and can only be matched by an edit
+        auto it = alphabet.find(codepoint);
+        if (it != alphabet.end())
+        {
+            peq[it->second] |= uint64_t(1) << patternLength;
+        }
+        pos += length;
+    }
+    if (patternLength == 0)
+    {
+        return results;
+    }
+
+    const uint32_t maxErrors = MaxErrors(patternLength);
+    for (uint32_t entry = 0; entry < Size(); ++entry)
+    {
+        uint32_t distance = UINT32_MAX;
+        for (uint32_t k = 2 * entry; k < 2 * entry + 2; ++k)
+        {
+            if (symbolOffsets[k + 1] > symbolOffsets[k])
+            {
+                distance = std::min(distance, SubstringDistance(peq, patternLength, symbols.data() + symbolOffsets[k],
+                                                                symbolOffsets[k + 1] - symbolOffsets[k]));
+            }
+        }
+        if (distance <= maxErrors)
+        {
+            results.push_back({entry, distance});
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [this](const FuzzyMatch &a, const FuzzyMatch &b)
+              {
+                  if (a.distance != b.distance)
+                      return a.distance < b.distance;
+                  size_t lengthA = Key(a.entry).size(), lengthB = Key(b.entry).size();
+                  return lengthA != lengthB ? lengthA < lengthB : a.entry < b.entry; });
+    if (results.size() > limit)
+    {
+        results.resize(limit);
+    }
+    return results;
+}
+
+const std::vector<uint32_t> &SearchIndex::Query::Update(const SearchIndex &index, const char *typed)
+{
+    bool sameIndex = source == &index && revision == index.revision;
+    if (sameIndex && text == typed)
+    {
+        return matches;
+    }
+
+    std::string newKey = Fold(typed);
+    if (sameIndex && !key.empty() && newKey.find(key) != std::string::npos)
+    {
+        // Every name containing the longer query also contains the previous one
+        exact.erase(std::remove_if(exact.begin(), exact.end(),
+                                   [&](uint32_t entry)
+                                   { return !index.Contains(entry, newKey); }),
+                    exact.end());
+    }
+    else
+    {
+        index.Search(newKey, exact);
+    }
+
+    matches = exact;
+    size_t added = 0;
+    for (const auto &match : index.FuzzySearch(newKey, exact.size() + kFuzzyLimit))
+    {
+        if (match.distance > 0 && added < kFuzzyLimit)
+        {
+            matches.push_back(match.entry);
+            ++added;
+        }
+    }
+
+    source = &index;
+    revision = index.revision;
+    text = typed;
+    key = std::move(newKey);
+    return matches;
+}
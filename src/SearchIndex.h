@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 콤보 박스 검색용 이름 색인
+ *
+ * Every name is stored under two precomputed keys, packed into one buffer each:
+ * the Unicode case-folded name and its chosung (초성) key, where each Hangul
+ * syllable is replaced by its initial consonant, so "ㄱㄹ" finds "가렌". A name
+ * matches when either key contains the folded query. Every two-byte sequence of
+ * both keys is recorded in a sorted posting table, so a query only verifies the
+ * names that contain its rarest bigram. Results are entry indices in the order
+ * the names were given.
+ *
+ * Both keys are also kept as strings of dense symbol ids, one per code point,
+ * for FuzzySearch, which ranks every name by a bit-parallel edit distance.
+ */
+class SearchIndex {
+public:
+    struct FuzzyMatch {
+        uint32_t entry;
+        uint32_t distance;                  // edits between the query and the closest part of the name
+    };
+
+    /**
+     * @brief Search state of one input box
+     *
+     * Update only does work when the text changed. When the new query contains
+     * the previous one, the previous matches are filtered instead of searching
+     * the whole index again. Names that only match with typos follow the exact
+     * matches, best first.
+     */
+    class Query {
+    public:
+        static constexpr size_t kFuzzyLimit = 8;
+
+        const std::vector<uint32_t>& Update(const SearchIndex& index, const char* text);
+        const std::vector<uint32_t>& Matches() const { return matches; }
+        size_t ExactCount() const { return exact.size(); }
+
+    private:
+        const SearchIndex* source = nullptr;
+        uint32_t revision = 0;
+        std::string text;                   // as typed
+        std::string key;                    // folded
+        std::vector<uint32_t> exact;
+        std::vector<uint32_t> matches;      // exact, then fuzzy
+    };
+
+    void Build(const std::vector<std::string>& names);
+    size_t Size() const { return keyOffsets.empty() ? 0 : keyOffsets.size() - 1; }
+    std::string_view Key(uint32_t entry) const;
+
+    std::string_view ChosungKey(uint32_t entry) const;
+
+    /**
+     * Names within MaxErrors(query) edits of the query, ranked by distance, then by name length.
+     */
+    std::vector<FuzzyMatch> FuzzySearch(std::string_view query, size_t limit) const;
+    static uint32_t MaxErrors(size_t queryLength);
+
+    static std::string Fold(std::string_view text);
+    static std::string Chosung(std::string_view folded);
+
+private:
+    void Search(std::string_view key, std::vector<uint32_t>& out) const;
+    bool Contains(uint32_t entry, std::string_view key) const;
+    void AddBigrams(uint32_t entry, std::string_view key);
+    void AddSymbols(std::string_view key);
+    static uint32_t Bigram(unsigned char a, unsigned char b) { return (uint32_t(a) << 8) | b; }
+
+    uint32_t revision = 0;
+    std::string keys;                       // folded names, back to back
+    std::vector<uint32_t> keyOffsets;       // entry i is keys[keyOffsets[i] .. keyOffsets[i + 1]]
+    std::string chosungKeys;
+    std::vector<uint32_t> chosungOffsets;
+    std::vector<uint64_t> bigrams;          // (bigram << 32) | entry, sorted, one per entry and bigram
+    std::unordered_map<uint32_t, uint16_t> alphabet;  // code point -> symbol id
+    std::vector<uint16_t> symbols;
+    std::vector<uint32_t> symbolOffsets;    // key 2i is entry i's folded name, 2i + 1 its chosung key
+};
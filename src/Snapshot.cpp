@@ -0,0 +1,385 @@
+#include "Snapshot.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+static const char kSnapshotMagic[8] = {'L', 'O', 'L', 'S', 'N', 'A', 'P', '\0'};
+
+const char *const kChampionStatNames[kChampionStatCount] = {
+    "hp", "hpperlevel", "mp", "mpperlevel", "movespeed",
+    "armor", "armorperlevel", "spellblock", "spellblockperlevel", "attackrange",
+    "hpregen", "hpregenperlevel", "mpregen", "mpregenperlevel", "crit",
+    "critperlevel", "attackdamage", "attackdamageperlevel", "attackspeedperlevel", "attackspeed"};
+
+// The records are written and read as raw memory, so their layout must not drift silently
+static_assert(sizeof(SnapshotString) == 8, "SnapshotString layout changed");
+static_assert(sizeof(SnapshotImage) == 32, "SnapshotImage layout changed");
+static_assert(sizeof(SnapshotChampion) == 152, "SnapshotChampion layout changed");
+static_assert(sizeof(SnapshotItem) == 84, "SnapshotItem layout changed");
+static_assert(sizeof(SnapshotSpell) == 76, "SnapshotSpell layout changed");
+
+// Snapshot -----------------------------------------------------------------------------------------------------------------
+
+bool Snapshot::Open(const std::filesystem::path &path)
+{
+    Close();
+    if (!file.Open(path))
+    {
+        return false;
+    }
+    if (!Attach(file.Data(), file.Size()))
+    {
+        std::cerr << "Ignoring invalid snapshot " << path << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool Snapshot::Adopt(std::vector<unsigned char> &&bytes)
+{
+    Close();
+    buffer = std::move(bytes);
+    if (!Attach(buffer.data(), buffer.size()))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void Snapshot::Close()
+{
+    file.Close();
+    buffer.clear();
+    buffer.shrink_to_fit();
+    base = nullptr;
+    size = 0;
+    header = nullptr;
+}
+
+bool Snapshot::Attach(const unsigned char *data, size_t length)
+{
+    if (length < sizeof(SnapshotHeader))
+    {
+        return false;
+    }
+
+    auto *candidate = reinterpret_cast<const SnapshotHeader *>(data);
+    if (std::memcmp(candidate->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        candidate->formatVersion != kFormatVersion ||
+        candidate->fileSize != length)
+    {
+        return false;
+    }
+
+    auto fits = [length](const SnapshotSection &section, size_t elementSize)
+    {
+        return section.offset % 4 == 0 &&
+               static_cast<uint64_t>(section.offset) + static_cast<uint64_t>(section.count) * elementSize <= length;
+    };
+    if (!fits(candidate->champions, sizeof(SnapshotChampion)) ||
+        !fits(candidate->items, sizeof(SnapshotItem)) ||
+        !fits(candidate->spells, sizeof(SnapshotSpell)) ||
+        !fits(candidate->itemStats, sizeof(SnapshotItemStat)) ||
+        !fits(candidate->itemActives, sizeof(SnapshotItemActive)) ||
+        !fits(candidate->strings, sizeof(SnapshotString)) ||
+        !fits(candidate->blob, 1) ||
+        candidate->blob.count == 0 ||
+        data[candidate->blob.offset + candidate->blob.count - 1] != '\0')
+    {
+        return false;
+    }
+
+    base = data;
+    size = length;
+    header = candidate;
+    return true;
+}
+
+template <typename T>
+Snapshot::Range<T> Snapshot::Section(const SnapshotSection &section) const
+{
+    Range<T> range;
+    if (header)
+    {
+        range.first = reinterpret_cast<const T *>(base + section.offset);
+        range.last = range.first + section.count;
+    }
+    return range;
+}
+
+template <typename T>
+Snapshot::Range<T> Snapshot::Slice(const SnapshotSection &section, const SnapshotList &list) const
+{
+    Range<T> range;
+    if (header && static_cast<uint64_t>(list.first) + list.count <= section.count)
+    {
+        range.first = reinterpret_cast<const T *>(base + section.offset) + list.first;
+        range.last = range.first + list.count;
+    }
+    return range;
+}
+
+std::string_view Snapshot::PatchVersion() const
+{
+    return header ? Str(header->patchVersion) : std::string_view();
+}
+
+Snapshot::Range<SnapshotString> Snapshot::Languages() const
+{
+    return header ? Strings(header->languages) : Range<SnapshotString>();
+}
+
+Snapshot::Range<SnapshotChampion> Snapshot::Champions() const
+{
+    return header ? Section<SnapshotChampion>(header->champions) : Range<SnapshotChampion>();
+}
+
+Snapshot::Range<SnapshotItem> Snapshot::Items() const
+{
+    return header ? Section<SnapshotItem>(header->items) : Range<SnapshotItem>();
+}
+
+Snapshot::Range<SnapshotSpell> Snapshot::Spells() const
+{
+    return header ? Section<SnapshotSpell>(header->spells) : Range<SnapshotSpell>();
+}
+
+const SnapshotChampion *Snapshot::FindChampion(std::string_view id) const
+{
+    auto champions = Champions();
+    auto it = std::lower_bound(champions.begin(), champions.end(), id,
+                               [this](const SnapshotChampion &champion, std::string_view value)
+                               { return Str(champion.id) < value; });
+    return (it != champions.end() && Str(it->id) == id) ? it : nullptr;
+}
+
+const SnapshotItem *Snapshot::FindItem(std::string_view id) const
+{
+    auto items = Items();
+    auto it = std::lower_bound(items.begin(), items.end(), id,
+                               [this](const SnapshotItem &item, std::string_view value)
+                               { return Str(item.id) < value; });
+    return (it != items.end() && Str(it->id) == id) ? it : nullptr;
+}
+
+std::string_view Snapshot::Str(const SnapshotString &str) const
+{
+    if (!header || static_cast<uint64_t>(str.offset) + str.length >= header->blob.count)
+    {
+        return std::string_view();
+    }
+    return std::string_view(reinterpret_cast<const char *>(base + header->blob.offset + str.offset), str.length);
+}
+
+const char *Snapshot::CStr(const SnapshotString &str) const
+{
+    if (!header || static_cast<uint64_t>(str.offset) + str.length >= header->blob.count)
+    {
+        return "";
+    }
+    return reinterpret_cast<const char *>(base + header->blob.offset + str.offset);
+}
+
+Snapshot::Range<SnapshotString> Snapshot::Strings(const SnapshotList &list) const
+{
+    return header ? Slice<SnapshotString>(header->strings, list) : Range<SnapshotString>();
+}
+
+Snapshot::Range<SnapshotItemStat> Snapshot::ItemStats(const SnapshotList &list) const
+{
+    return header ? Slice<SnapshotItemStat>(header->itemStats, list) : Range<SnapshotItemStat>();
+}
+
+Snapshot::Range<SnapshotItemActive> Snapshot::ItemActives(const SnapshotList &list) const
+{
+    return header ? Slice<SnapshotItemActive>(header->itemActives, list) : Range<SnapshotItemActive>();
+}
+
+// SnapshotBuilder ----------------------------------------------------------------------------------------------------------
+
+void SnapshotBuilder::SetPatchVersion(const std::string &version)
+{
+    patchVersion = version;
+}
+
+void SnapshotBuilder::SetLanguages(std::vector<std::string> languageIds)
+{
+    languages = std::move(languageIds);
+}
+
+void SnapshotBuilder::SetChampions(std::vector<Champion> records)
+{
+    champions = std::move(records);
+}
+
+void SnapshotBuilder::SetItems(std::vector<Item> records)
+{
+    items = std::move(records);
+}
+
+void SnapshotBuilder::SetSpells(std::vector<Spell> records)
+{
+    spells = std::move(records);
+}
+
+std::vector<unsigned char> SnapshotBuilder::Build()
+{
+    // Lookups binary search on the id, so both sections are stored sorted
+    std::sort(champions.begin(), champions.end(), [](const Champion &a, const Champion &b)
+              { return a.id < b.id; });
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b)
+              { return a.id < b.id; });
+
+    std::string blob(1, '\0'); // offset 0 is the empty string
+    std::unordered_map<std::string, SnapshotString> interned;
+    auto intern = [&](const std::string &value) -> SnapshotString
+    {
+        if (value.empty())
+        {
+            return SnapshotString{0, 0};
+        }
+        auto it = interned.find(value);
+        if (it != interned.end())
+        {
+            return it->second;
+        }
+        SnapshotString str{static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(value.size())};
+        blob.append(value);
+        blob.push_back('\0');
+        interned.emplace(value, str);
+        return str;
+    };
+
+    std::vector<SnapshotString> strings;
+    auto addStrings = [&](const std::vector<std::string> &values) -> SnapshotList
+    {
+        SnapshotList list{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(values.size())};
+        for (const auto &value : values)
+        {
+            strings.push_back(intern(value));
+        }
+        return list;
+    };
+    auto addImage = [&](const Image &image) -> SnapshotImage
+    {
+        return SnapshotImage{intern(image.full), intern(image.sprite), image.x, image.y, image.w, image.h};
+    };
+
+    std::vector<SnapshotChampion> championRecords;
+    championRecords.reserve(champions.size());
+    for (const auto &champion : champions)
+    {
+        SnapshotChampion record{};
+        record.id = intern(champion.id);
+        record.key = intern(champion.key);
+        record.name = intern(champion.name);
+        record.title = intern(champion.title);
+        record.tags = addStrings(champion.tags);
+        record.image = addImage(champion.image);
+        std::copy(std::begin(champion.stats), std::end(champion.stats), record.stats);
+        championRecords.push_back(record);
+    }
+
+    std::vector<SnapshotItem> itemRecords;
+    std::vector<SnapshotItemStat> itemStats;
+    std::vector<SnapshotItemActive> itemActives;
+    itemRecords.reserve(items.size());
+    for (const auto &item : items)
+    {
+        SnapshotItem record{};
+        record.id = intern(item.id);
+        record.name = intern(item.name);
+        record.icon = intern(item.icon);
+        record.description = intern(item.description);
+        record.cost = item.cost;
+        record.sell = item.sell;
+        record.purchasable = item.purchasable ? 1 : 0;
+        record.tags = addStrings(item.tags);
+        record.buildsFrom = addStrings(item.buildsFrom);
+        record.buildsInto = addStrings(item.buildsInto);
+
+        record.stats = SnapshotList{static_cast<uint32_t>(itemStats.size()), static_cast<uint32_t>(item.stats.size())};
+        for (const auto &stat : item.stats)
+        {
+            itemStats.push_back(SnapshotItemStat{intern(stat.name), stat.flat, stat.percent});
+        }
+
+        record.actives = SnapshotList{static_cast<uint32_t>(itemActives.size()), static_cast<uint32_t>(item.actives.size())};
+        for (const auto &active : item.actives)
+        {
+            itemActives.push_back(SnapshotItemActive{intern(active.name), intern(active.effects), intern(active.cooldown)});
+        }
+        itemRecords.push_back(record);
+    }
+
+    std::vector<SnapshotSpell> spellRecords;
+    spellRecords.reserve(spells.size());
+    for (const auto &spell : spells)
+    {
+        SnapshotSpell record{};
+        record.id = intern(spell.id);
+        record.name = intern(spell.name);
+        record.description = intern(spell.description);
+        record.cooldownBurn = intern(spell.cooldownBurn);
+        record.summonerLevel = spell.summonerLevel;
+        record.modes = addStrings(spell.modes);
+        record.image = addImage(spell.image);
+        spellRecords.push_back(record);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.formatVersion = Snapshot::kFormatVersion;
+    header.patchVersion = intern(patchVersion);
+    header.languages = addStrings(languages);
+
+    std::vector<unsigned char> bytes(sizeof(SnapshotHeader));
+    auto appendSection = [&bytes](const void *data, size_t elementSize, size_t count) -> SnapshotSection
+    {
+        bytes.resize((bytes.size() + 7) & ~size_t(7));
+        SnapshotSection section{static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(count)};
+        const auto *first = static_cast<const unsigned char *>(data);
+        bytes.insert(bytes.end(), first, first + elementSize * count);
+        return section;
+    };
+    header.champions = appendSection(championRecords.data(), sizeof(SnapshotChampion), championRecords.size());
+    header.items = appendSection(itemRecords.data(), sizeof(SnapshotItem), itemRecords.size());
+    header.spells = appendSection(spellRecords.data(), sizeof(SnapshotSpell), spellRecords.size());
+    header.itemStats = appendSection(itemStats.data(), sizeof(SnapshotItemStat), itemStats.size());
+    header.itemActives = appendSection(itemActives.data(), sizeof(SnapshotItemActive), itemActives.size());
+    header.strings = appendSection(strings.data(), sizeof(SnapshotString), strings.size());
+    header.blob = appendSection(blob.data(), 1, blob.size());
+    header.fileSize = static_cast<uint32_t>(bytes.size());
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    return bytes;
+}
+
+bool SnapshotBuilder::WriteFile(const std::filesystem::path &path, const std::vector<unsigned char> &bytes)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        if (!file)
+        {
+            std::cerr << "Failed to write snapshot " << tmpPath << std::endl;
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to replace snapshot " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
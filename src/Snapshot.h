@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+#include "MappedFile.h"
+#include "Span.h"
+
+/**
+ * @brief 챔피언 / 아이템 / 소환사 주문 레코드의 바이너리 스냅샷
+ *
+ * The file is a fixed header followed by arrays of plain records that refer to
+ * a shared string blob by offset. It is memory-mapped and read in place, so
+ * loading it needs no parse step. All strings in the blob are NUL-terminated
+ * and can be handed to ImGui directly.
+ */
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotList {
+    uint32_t first;
+    uint32_t count;
+};
+
+struct SnapshotSection {
+    uint32_t offset;
+    uint32_t count;
+};
+
+struct SnapshotImage {
+    SnapshotString full;
+    SnapshotString sprite;
+    int32_t x, y, w, h;
+};
+
+/**
+ * Order of the champion stats in SnapshotChampion::stats, see kChampionStatNames.
+ */
+enum class ChampionStat : uint32_t {
+    Hp, HpPerLevel, Mp, MpPerLevel, MoveSpeed,
+    Armor, ArmorPerLevel, SpellBlock, SpellBlockPerLevel, AttackRange,
+    HpRegen, HpRegenPerLevel, MpRegen, MpRegenPerLevel, Crit,
+    CritPerLevel, AttackDamage, AttackDamagePerLevel, AttackSpeedPerLevel, AttackSpeed,
+    Count
+};
+constexpr size_t kChampionStatCount = static_cast<size_t>(ChampionStat::Count);
+extern const char* const kChampionStatNames[kChampionStatCount];
+
+struct SnapshotChampion {
+    SnapshotString id;
+    SnapshotString key;
+    SnapshotString name;
+    SnapshotString title;
+    SnapshotList tags;          // -> strings
+    SnapshotImage image;
+    float stats[kChampionStatCount];
+};
+
+struct SnapshotItemStat {
+    SnapshotString name;
+    float flat;
+    float percent;
+};
+
+struct SnapshotItemActive {
+    SnapshotString name;
+    SnapshotString effects;
+    SnapshotString cooldown;
+};
+
+struct SnapshotItem {
+    SnapshotString id;
+    SnapshotString name;
+    SnapshotString icon;
+    SnapshotString description;
+    int32_t cost;               // -1 when unknown
+    int32_t sell;               // -1 when unknown
+    uint32_t purchasable;
+    SnapshotList tags;          // -> strings
+    SnapshotList stats;         // -> itemStats
+    SnapshotList buildsFrom;    // -> strings
+    SnapshotList buildsInto;    // -> strings
+    SnapshotList actives;       // -> itemActives
+};
+
+struct SnapshotSpell {
+    SnapshotString id;
+    SnapshotString name;
+    SnapshotString description;
+    SnapshotString cooldownBurn;
+    int32_t summonerLevel;
+    SnapshotList modes;         // -> strings
+    SnapshotImage image;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t fileSize;
+    SnapshotString patchVersion;
+    SnapshotList languages;     // -> strings
+    SnapshotSection champions;
+    SnapshotSection items;
+    SnapshotSection spells;
+    SnapshotSection itemStats;
+    SnapshotSection itemActives;
+    SnapshotSection strings;    // SnapshotString lists
+    SnapshotSection blob;       // raw characters, count is in bytes
+};
+
+/**
+ * @brief Read-only view over a snapshot, either memory-mapped or held in memory.
+ */
+class Snapshot {
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+
+    template <typename T>
+    using Range = Span<T>;
+
+    bool Open(const std::filesystem::path& path);
+    bool Adopt(std::vector<unsigned char>&& bytes);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+    size_t SizeBytes() const { return size; }
+
+    std::string_view PatchVersion() const;
+    Range<SnapshotString> Languages() const;
+
+    Range<SnapshotChampion> Champions() const;
+    Range<SnapshotItem> Items() const;
+    Range<SnapshotSpell> Spells() const;
+    const SnapshotChampion* FindChampion(std::string_view id) const;
+    const SnapshotItem* FindItem(std::string_view id) const;
+
+    std::string_view Str(const SnapshotString& str) const;
+    const char* CStr(const SnapshotString& str) const;
+    Range<SnapshotString> Strings(const SnapshotList& list) const;
+    Range<SnapshotItemStat> ItemStats(const SnapshotList& list) const;
+    Range<SnapshotItemActive> ItemActives(const SnapshotList& list) const;
+
+private:
+    bool Attach(const unsigned char* data, size_t length);
+    template <typename T>
+    Range<T> Section(const SnapshotSection& section) const;
+    template <typename T>
+    Range<T> Slice(const SnapshotSection& section, const SnapshotList& list) const;
+
+    MappedFile file;
+    std::vector<unsigned char> buffer;
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+    const SnapshotHeader* header = nullptr;
+};
+
+/**
+ * @brief Collects extracted records and serializes them into the snapshot format.
+ *
+ * Each setter only touches its own section, so the startup stages may fill the
+ * builder concurrently.
+ */
+class SnapshotBuilder {
+public:
+    struct Image {
+        std::string full;
+        std::string sprite;
+        int x = 0, y = 0, w = 0, h = 0;
+    };
+    struct Champion {
+        std::string id;
+        std::string key;
+        std::string name;
+        std::string title;
+        std::vector<std::string> tags;
+        Image image;
+        float stats[kChampionStatCount] = {};
+    };
+    struct ItemStat {
+        std::string name;
+        float flat = 0.0f;
+        float percent = 0.0f;
+    };
+    struct ItemActive {
+        std::string name;
+        std::string effects;
+        std::string cooldown;
+    };
+    struct Item {
+        std::string id;
+        std::string name;
+        std::string icon;
+        std::string description;
+        int cost = -1;
+        int sell = -1;
+        bool purchasable = false;
+        std::vector<std::string> tags;
+        std::vector<ItemStat> stats;
+        std::vector<std::string> buildsFrom;
+        std::vector<std::string> buildsInto;
+        std::vector<ItemActive> actives;
+    };
+    struct Spell {
+        std::string id;
+        std::string name;
+        std::string description;
+        std::string cooldownBurn;
+        int summonerLevel = 0;
+        std::vector<std::string> modes;
+        Image image;
+    };
+
+    void SetPatchVersion(const std::string& version);
+    void SetLanguages(std::vector<std::string> languageIds);
+    void SetChampions(std::vector<Champion> records);
+    void SetItems(std::vector<Item> records);
+    void SetSpells(std::vector<Spell> records);
+
+    std::vector<unsigned char> Build();
+    static bool WriteFile(const std::filesystem::path& path, const std::vector<unsigned char>& bytes);
+
+private:
+    std::string patchVersion;
+    std::vector<std::string> languages;
+    std::vector<Champion> champions;
+    std::vector<Item> items;
+    std::vector<Spell> spells;
+};
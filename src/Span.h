@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief 연속된 배열의 일부를 가리키는 읽기 전용 뷰
+ *
+ * Stand-in for std::span, which is not available in C++17. It never owns the
+ * elements; the container it points into must outlive it.
+ */
+template <typename T>
+struct Span {
+    const T* first = nullptr;
+    const T* last = nullptr;
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    const T* data() const { return first; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    const T& operator[](size_t index) const { return first[index]; }
+};
@@ -0,0 +1,41 @@
+#include "StreamPipe.h"
+
+void StreamPipe::Write(const char *data, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    chunks.emplace_back(data, size);
+    ready.notify_one();
+}
+
+void StreamPipe::Close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    ready.notify_all();
+}
+
+StreamPipe::int_type StreamPipe::underflow()
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [this]() { return !chunks.empty() || closed; });
+    if (chunks.empty())
+    {
+        return traits_type::eof();
+    }
+    current = std::move(chunks.front());
+    chunks.pop_front();
+    lock.unlock();
+
+    char *begin = &current[0];
+    setg(begin, begin, begin + current.size());
+    return traits_type::to_int_type(*gptr());
+}
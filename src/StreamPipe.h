@@ -0,0 +1,30 @@
+#pragma once
+
+#include <streambuf>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief 한 스레드가 쓰고 다른 스레드가 읽는 스트림 버퍼
+ *
+ * A producer appends chunks as they arrive and a consumer reads them through a
+ * std::istream, blocking until more data is written or the pipe is closed. This
+ * lets a parser run while the body is still downloading.
+ */
+class StreamPipe : public std::streambuf {
+public:
+    void Write(const char* data, size_t size);
+    void Close();
+
+protected:
+    int_type underflow() override;
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::string> chunks;
+    std::string current;  // chunk the get area points into
+    bool closed = false;
+};
@@ -0,0 +1,500 @@
+#include "TextIndex.h"
+#include "SearchIndex.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+static const char kTextIndexMagic[8] = {'L', 'O', 'L', 'T', 'E', 'X', 'T', '1'};
+
+// BM25 parameters, the usual defaults
+static const double kTermSaturation = 1.2;
+static const double kLengthNormalization = 0.75;
+
+static bool IsHangul(uint32_t c)
+{
+    return (c >= 0xAC00 && c <= 0xD7A3) || (c >= 0x3131 && c <= 0x318E) || (c >= 0x1100 && c <= 0x11FF);
+}
+
+static bool IsWordCharacter(uint32_t c)
+{
+    if (c < 0x80)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+    }
+    // Everything above ASCII except punctuation and symbol blocks is treated as a letter
+    return !(c <= 0xBF || c == 0xD7 || c == 0xF7 || (c >= 0x2000 && c <= 0x2BFF) ||
+             (c >= 0x3000 && c <= 0x303F) || (c >= 0xFF00 && c <= 0xFF0F));
+}
+
+/**
+ * Light English suffix strip so inflected forms share a term: slows / slowed / slowing -> slow.
+ */
+static void StripSuffix(std::string &word)
+{
+    auto endsWith = [&](const char *suffix)
+    {
+        size_t length = std::strlen(suffix);
+        return word.size() > length + 2 && word.compare(word.size() - length, length, suffix) == 0;
+    };
+    if (endsWith("ies"))
+    {
+        word.replace(word.size() - 3, 3, "y");
+    }
+    else if (endsWith("ing") || (endsWith("ed") && word[word.size() - 3] != 'e'))
+    {
+        word.resize(word.size() - (word.back() == 'g' ? 3 : 2));
+    }
+    else if (endsWith("s") && !endsWith("ss"))
+    {
+        word.pop_back();
+    }
+}
+
+std::vector<std::string> TextIndex::Tokenize(std::string_view text)
+{
+    std::vector<std::string> tokens;
+    std::string folded = SearchIndex::Fold(text);
+    std::string word;
+    std::vector<std::string> syllables;
+
+    auto flushWord = [&]()
+    {
+        if (!word.empty())
+        {
+            StripSuffix(word);
+            tokens.push_back(std::move(word));
+            word.clear();
+        }
+    };
+    auto flushHangul = [&]()
+    {
+        if (syllables.size() == 1)
+        {
+            tokens.push_back(syllables[0]);
+        }
+        for (size_t i = 1; i < syllables.size(); ++i)
+        {
+            tokens.push_back(syllables[i - 1] + syllables[i]);
+        }
+        syllables.clear();
+    };
+
+    for (size_t pos = 0; pos < folded.size();)
+    {
+        // Skip markup and template placeholders, as in "<br>" and "{{ e1 }}"
+        if (folded[pos] == '<' || folded.compare(pos, 2, "{{") == 0)
+        {
+            size_t end = folded[pos] == '<' ? folded.find('>', pos) : folded.find("}}", pos);
+            flushWord();
+            flushHangul();
+            pos = end == std::string::npos ? folded.size() : end + (folded[pos] == '<' ? 1 : 2);
+            continue;
+        }
+
+        uint32_t codepoint = 0;
+        size_t length = DecodeUtf8(folded, pos, codepoint);
+        if (length == 0)
+        {
+            length = 1;
+            codepoint = ' ';
+        }
+        if (IsHangul(codepoint))
+        {
+            flushWord();
+            syllables.emplace_back(folded, pos, length);
+        }
+        else if (IsWordCharacter(codepoint))
+        {
+            flushHangul();
+            word.append(folded, pos, length);
+        }
+        else
+        {
+            flushWord();
+            flushHangul();
+        }
+        pos += length;
+    }
+    flushWord();
+    flushHangul();
+    return tokens;
+}
+
+void TextIndex::Build(std::vector<Document> newDocuments, size_t threadCount)
+{
+    documents = std::move(newDocuments);
+    documentLengths.assign(documents.size(), 0);
+    termIds.clear();
+    terms.clear();
+
+    // Each worker indexes a contiguous range of documents into its own term table
+    struct Partial {
+        std::unordered_map<std::string, uint32_t> termIds;
+        std::vector<Term> terms;
+        std::vector<std::string> order;     // terms in first-seen order
+    };
+    threadCount = std::max<size_t>(1, std::min(threadCount, documents.size()));
+    std::vector<Partial> partials(threadCount);
+    auto indexRange = [&](size_t worker)
+    {
+        Partial &partial = partials[worker];
+        size_t first = documents.size() * worker / threadCount;
+        size_t last = documents.size() * (worker + 1) / threadCount;
+        for (size_t document = first; document < last; ++document)
+        {
+            std::vector<std::string> tokens = Tokenize(documents[document].text);
+            documentLengths[document] = static_cast<uint32_t>(tokens.size());
+
+            std::unordered_map<std::string, std::vector<uint32_t>> positions;
+            for (uint32_t position = 0; position < tokens.size(); ++position)
+            {
+                positions[tokens[position]].push_back(position);
+            }
+            for (auto &[token, tokenPositions] : positions)
+            {
+                auto [it, inserted] = partial.termIds.emplace(token, static_cast<uint32_t>(partial.terms.size()));
+                if (inserted)
+                {
+                    partial.terms.emplace_back();
+                    partial.order.push_back(token);
+                }
+                Term &term = partial.terms[it->second];
+                term.postings.push_back({static_cast<uint32_t>(document), static_cast<uint32_t>(term.positions.size()),
+                                         static_cast<uint32_t>(tokenPositions.size())});
+                term.positions.insert(term.positions.end(), tokenPositions.begin(), tokenPositions.end());
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < threadCount; ++worker)
+    {
+        workers.emplace_back(indexRange, worker);
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    // Merging in range order keeps every posting list sorted by document
+    for (auto &partial : partials)
+    {
+        for (const auto &token : partial.order)
+        {
+            Term &source = partial.terms[partial.termIds[token]];
+            auto [it, inserted] = termIds.emplace(token, static_cast<uint32_t>(terms.size()));
+            if (inserted)
+            {
+                terms.emplace_back();
+            }
+            Term &target = terms[it->second];
+            uint32_t base = static_cast<uint32_t>(target.positions.size());
+            for (Posting posting : source.postings)
+            {
+                posting.firstPosition += base;
+                target.postings.push_back(posting);
+            }
+            target.positions.insert(target.positions.end(), source.positions.begin(), source.positions.end());
+        }
+    }
+    UpdateAverageLength();
+}
+
+void TextIndex::UpdateAverageLength()
+{
+    double total = 0.0;
+    for (uint32_t length : documentLengths)
+    {
+        total += length;
+    }
+    averageLength = documentLengths.empty() ? 0.0 : total / documentLengths.size();
+}
+
+const TextIndex::Term *TextIndex::FindTerm(const std::string &token) const
+{
+    auto it = termIds.find(token);
+    return it != termIds.end() ? &terms[it->second] : nullptr;
+}
+
+bool TextIndex::ContainsPhrase(const std::vector<const Term *> &phrase, uint32_t document) const
+{
+    // Positions of every word, shifted back by its offset in the phrase, must share a value
+    std::vector<uint32_t> starts;
+    for (size_t i = 0; i < phrase.size(); ++i)
+    {
+        const auto &postings = phrase[i]->postings;
+        auto it = std::lower_bound(postings.begin(), postings.end(), document,
+                                   [](const Posting &posting, uint32_t value)
+                                   { return posting.document < value; });
+        if (it == postings.end() || it->document != document)
+        {
+            return false;
+        }
+        std::vector<uint32_t> shifted;
+        for (uint32_t p = 0; p < it->positionCount; ++p)
+        {
+            uint32_t position = phrase[i]->positions[it->firstPosition + p];
+            if (position >= i)
+            {
+                shifted.push_back(position - static_cast<uint32_t>(i));
+            }
+        }
+        if (i == 0)
+        {
+            starts = std::move(shifted);
+        }
+        else
+        {
+            std::vector<uint32_t> common;
+            std::set_intersection(starts.begin(), starts.end(), shifted.begin(), shifted.end(), std::back_inserter(common));
+            starts = std::move(common);
+        }
+        if (starts.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Words outside quotes are alternatives ranked by BM25. Every quoted phrase must match.
+ */
+std::vector<TextIndex::Hit> TextIndex::Search(std::string_view query, size_t limit) const
+{
+    std::vector<std::string> tokens;
+    std::vector<std::vector<std::string>> phrases;
+    bool quoted = false;
+    for (size_t pos = 0; pos <= query.size();)
+    {
+        size_t end = query.find('"', pos);
+        std::string_view part = query.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        std::vector<std::string> partTokens = Tokenize(part);
+        if (quoted && partTokens.size() > 1)
+        {
+            phrases.push_back(partTokens);
+        }
+        tokens.insert(tokens.end(), partTokens.begin(), partTokens.end());
+        if (end == std::string_view::npos)
+        {
+            break;
+        }
+        pos = end + 1;
+        quoted = !quoted;
+    }
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+    std::vector<float> scores(documents.size(), 0.0f);
+    std::vector<uint32_t> touched;
+    const double documentCount = static_cast<double>(documents.size());
+    for (const auto &token : tokens)
+    {
+        const Term *term = FindTerm(token);
+        if (!term)
+        {
+            continue;
+        }
+        double frequency = static_cast<double>(term->postings.size());
+        double idf = std::log(1.0 + (documentCount - frequency + 0.5) / (frequency + 0.5));
+        for (const auto &posting : term->postings)
+        {
+            double tf = posting.positionCount;
+            double norm = 1.0 - kLengthNormalization + kLengthNormalization * documentLengths[posting.document] / std::max(averageLength, 1.0);
+            if (scores[posting.document] == 0.0f)
+            {
+                touched.push_back(posting.document);
+            }
+            scores[posting.document] += static_cast<float>(idf * tf * (kTermSaturation + 1.0) / (tf + kTermSaturation * norm));
+        }
+    }
+
+    std::vector<std::vector<const Term *>> phraseTerms;
+    for (const auto &phrase : phrases)
+    {
+        std::vector<const Term *> words;
+        for (const auto &token : phrase)
+        {
+            const Term *term = FindTerm(token);
+            if (!term)
+            {
+                return {};
+            }
+            words.push_back(term);
+        }
+        phraseTerms.push_back(std::move(words));
+    }
+
+    std::vector<Hit> hits;
+    for (uint32_t document : touched)
+    {
+        bool matches = std::all_of(phraseTerms.begin(), phraseTerms.end(),
+                                   [&](const std::vector<const Term *> &phrase)
+                                   { return ContainsPhrase(phrase, document); });
+        if (matches)
+        {
+            hits.push_back({document, scores[document]});
+        }
+    }
+    auto better = [](const Hit &a, const Hit &b)
+    { return a.score != b.score ? a.score > b.score : a.document < b.document; };
+    if (hits.size() > limit)
+    {
+        std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), better);
+        hits.resize(limit);
+    }
+    else
+    {
+        std::sort(hits.begin(), hits.end(), better);
+    }
+    return hits;
+}
+
+// Persistence: a small binary file of little-endian integers and length-prefixed strings
+
+static void WriteU32(std::ostream &out, uint32_t value)
+{
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void WriteString(std::ostream &out, const std::string &value)
+{
+    WriteU32(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+static bool ReadU32(std::istream &in, uint32_t &value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+static bool ReadString(std::istream &in, std::string &value)
+{
+    uint32_t length = 0;
+    if (!ReadU32(in, length) || length > (1u << 26))
+    {
+        return false;
+    }
+    value.resize(length);
+    return static_cast<bool>(in.read(&value[0], length));
+}
+
+bool TextIndex::Save(const std::filesystem::path &path, const std::string &version) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(kTextIndexMagic, sizeof(kTextIndexMagic));
+        WriteString(file, version);
+        WriteU32(file, static_cast<uint32_t>(documents.size()));
+        for (size_t i = 0; i < documents.size(); ++i)
+        {
+            WriteU32(file, documents[i].kind);
+            WriteU32(file, documents[i].owner);
+            WriteU32(file, documents[i].part);
+            WriteU32(file, documentLengths[i]);
+            WriteString(file, documents[i].text);
+        }
+        WriteU32(file, static_cast<uint32_t>(terms.size()));
+        for (const auto &[token, id] : termIds)
+        {
+            const Term &term = terms[id];
+            WriteString(file, token);
+            WriteU32(file, static_cast<uint32_t>(term.postings.size()));
+            for (const auto &posting : term.postings)
+            {
+                WriteU32(file, posting.document);
+                WriteU32(file, posting.positionCount);
+            }
+            file.write(reinterpret_cast<const char *>(term.positions.data()), term.positions.size() * sizeof(uint32_t));
+        }
+        if (!file)
+        {
+            std::cerr << "Failed to write text index " << tmpPath << std::endl;
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to replace text index " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TextIndex::Load(const std::filesystem::path &path, const std::string &version)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kTextIndexMagic)] = {};
+    std::string fileVersion;
+    if (!file || !file.read(magic, sizeof(magic)) || std::memcmp(magic, kTextIndexMagic, sizeof(magic)) != 0 ||
+        !ReadString(file, fileVersion) || fileVersion != version)
+    {
+        return false;
+    }
+
+    TextIndex loaded;
+    uint32_t documentCount = 0;
+    if (!ReadU32(file, documentCount))
+    {
+        return false;
+    }
+    loaded.documents.resize(documentCount);
+    loaded.documentLengths.resize(documentCount);
+    for (uint32_t i = 0; i < documentCount; ++i)
+    {
+        Document &document = loaded.documents[i];
+        if (!ReadU32(file, document.kind) || !ReadU32(file, document.owner) || !ReadU32(file, document.part) ||
+            !ReadU32(file, loaded.documentLengths[i]) || !ReadString(file, document.text))
+        {
+            return false;
+        }
+    }
+
+    uint32_t termCount = 0;
+    if (!ReadU32(file, termCount))
+    {
+        return false;
+    }
+    loaded.terms.resize(termCount);
+    for (uint32_t id = 0; id < termCount; ++id)
+    {
+        std::string token;
+        uint32_t postingCount = 0;
+        if (!ReadString(file, token) || !ReadU32(file, postingCount) || postingCount > documentCount)
+        {
+            return false;
+        }
+        Term &term = loaded.terms[id];
+        uint32_t positionCount = 0;
+        for (uint32_t p = 0; p < postingCount; ++p)
+        {
+            Posting posting = {0, positionCount, 0};
+            if (!ReadU32(file, posting.document) || !ReadU32(file, posting.positionCount) || posting.document >= documentCount ||
+                posting.positionCount > loaded.documentLengths[posting.document])
+            {
+                return false;
+            }
+            positionCount += posting.positionCount;
+            term.postings.push_back(posting);
+        }
+        term.positions.resize(positionCount);
+        if (!file.read(reinterpret_cast<char *>(term.positions.data()), positionCount * sizeof(uint32_t)))
+        {
+            return false;
+        }
+        loaded.termIds.emplace(std::move(token), id);
+    }
+
+    loaded.UpdateAverageLength();
+    *this = std::move(loaded);
+    return true;
+}
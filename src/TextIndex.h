@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+
+/**
+ * @brief 배경 이야기 / 스킬 설명 / 팁 같은 긴 텍스트의 전문 검색 색인
+ *
+ * An inverted index from terms to positional postings, ranked with BM25.
+ * Latin, Greek and Cyrillic text is split into case-folded words with a light
+ * English suffix strip, so "slowed" finds "slows". Runs of Hangul are indexed
+ * as overlapping syllable bigrams, so a Korean stem still matches when
+ * particles or endings are attached. Markup such as <br> is skipped. Quoted
+ * parts of a query must appear in the document as a phrase.
+ */
+class TextIndex {
+public:
+    struct Document {
+        uint32_t kind = 0;          // meaning is up to the caller
+        uint32_t owner = 0;
+        uint32_t part = 0;
+        std::string text;
+    };
+    struct Hit {
+        uint32_t document;
+        float score;
+    };
+
+    /**
+     * Indexes the documents on threadCount workers, each over a contiguous range, then merges the results.
+     */
+    void Build(std::vector<Document> documents, size_t threadCount);
+    bool Save(const std::filesystem::path& path, const std::string& version) const;
+    bool Load(const std::filesystem::path& path, const std::string& version);
+
+    std::vector<Hit> Search(std::string_view query, size_t limit) const;
+    size_t DocumentCount() const { return documents.size(); }
+    const Document& GetDocument(uint32_t document) const { return documents[document]; }
+
+    static std::vector<std::string> Tokenize(std::string_view text);
+
+private:
+    struct Posting {
+        uint32_t document;
+        uint32_t firstPosition;     // into Term::positions
+        uint32_t positionCount;
+    };
+    struct Term {
+        std::vector<Posting> postings;  // ascending document order
+        std::vector<uint32_t> positions;
+    };
+
+    const Term* FindTerm(const std::string& token) const;
+    bool ContainsPhrase(const std::vector<const Term*>& phrase, uint32_t document) const;
+    void UpdateAverageLength();
+
+    std::vector<Document> documents;
+    std::vector<uint32_t> documentLengths;  // in tokens
+    double averageLength = 0.0;
+    std::unordered_map<std::string, uint32_t> termIds;
+    std::vector<Term> terms;
+};
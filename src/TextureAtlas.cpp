@@ -0,0 +1,278 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+
+// transparent texels right and below each entry so linear filtering never pulls in a neighbour
+static const int kPadding = 1;
+
+TextureAtlas::TextureAtlas(int pageSize, size_t maxPages)
+    : pageSize(pageSize), maxPages(std::max<size_t>(maxPages, 1))
+{
+}
+
+TextureAtlas::Entry TextureAtlas::Create()
+{
+    if (pages.empty() && AddPage())
+    {
+        // a cell no entry ever gets, drawn for entries that have no pixels yet
+        int x = 0, y = 0;
+        Allocate(0, 2 + kPadding, 2 + kPadding, x, y);
+        placeholder.texture = pages[0].texture;
+        placeholder.x = x;
+        placeholder.y = y;
+        placeholder.width = placeholder.height = 2;
+        placeholder.u0 = (x + 0.5f) / pageSize;
+        placeholder.v0 = (y + 0.5f) / pageSize;
+        placeholder.u1 = (x + 1.5f) / pageSize;
+        placeholder.v1 = (y + 1.5f) / pageSize;
+    }
+
+    Entry entry;
+    if (!freeEntries.empty())
+    {
+        entry = freeEntries.back();
+        freeEntries.pop_back();
+    }
+    else
+    {
+        entry = static_cast<Entry>(entries.size());
+        entries.emplace_back();
+    }
+    entries[entry] = Slot{};
+    entries[entry].alive = true;
+    entries[entry].lastUsed = frame;
+    return entry;
+}
+
+void TextureAtlas::Destroy(Entry entry)
+{
+    Slot &slot = entries[entry];
+    if (!slot.alive)
+    {
+        return;
+    }
+    Release(slot);
+    slot.alive = false;
+    freeEntries.push_back(entry);
+}
+
+bool TextureAtlas::Place(Entry entry, int width, int height)
+{
+    Slot &slot = entries[entry];
+    Release(slot);
+    if (width <= 0 || height <= 0 || width + kPadding > pageSize || height + kPadding > pageSize)
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        int x = 0, y = 0;
+        for (size_t page = 0; page < pages.size(); ++page)
+        {
+            if (Allocate(page, width + kPadding, height + kPadding, x, y))
+            {
+                slot.page = static_cast<int>(page);
+                slot.region.texture = pages[page].texture;
+                slot.region.x = x;
+                slot.region.y = y;
+                slot.region.width = width;
+                slot.region.height = height;
+                slot.region.u0 = static_cast<float>(x) / pageSize;
+                slot.region.v0 = static_cast<float>(y) / pageSize;
+                slot.region.u1 = static_cast<float>(x + width) / pageSize;
+                slot.region.v1 = static_cast<float>(y + height) / pageSize;
+                slot.lastUsed = frame;
+                return true;
+            }
+        }
+        if (!AddPage() && !EvictOne())
+        {
+            return false;
+        }
+    }
+}
+
+const TextureAtlas::Region &TextureAtlas::Use(Entry entry)
+{
+    Slot &slot = entries[entry];
+    slot.lastUsed = frame;
+    return slot.page >= 0 ? slot.region : placeholder;
+}
+
+void TextureAtlas::Clear()
+{
+    for (Page &page : pages)
+    {
+        glDeleteTextures(1, &page.texture);
+    }
+    pages.clear();
+    for (Slot &slot : entries)
+    {
+        slot.page = -1;
+    }
+    placeholder = Region{};
+}
+
+TextureAtlas::Stats TextureAtlas::GetStats() const
+{
+    Stats stats;
+    stats.pages = pages.size();
+    stats.entries = entries.size() - freeEntries.size();
+    stats.evictions = evictions;
+    stats.pagePixels = pages.size() * pageSize * pageSize;
+    for (const Slot &slot : entries)
+    {
+        if (slot.alive && slot.page >= 0)
+        {
+            stats.placed++;
+            stats.usedPixels += static_cast<size_t>(slot.region.width) * slot.region.height;
+        }
+    }
+    return stats;
+}
+
+/**
+ * Takes the shelf wasting the least height, or cuts an empty one down to size.
+ */
+bool TextureAtlas::Allocate(size_t pageIndex, int width, int height, int &x, int &y)
+{
+    std::vector<Shelf> &shelves = pages[pageIndex].shelves;
+    auto fits = [width](const Shelf &shelf)
+    {
+        return std::any_of(shelf.free.begin(), shelf.free.end(), [width](const Span &span) { return span.width >= width; });
+    };
+
+    size_t best = shelves.size();
+    for (size_t i = 0; i < shelves.size(); ++i)
+    {
+        const Shelf &shelf = shelves[i];
+        if (shelf.used == 0 || shelf.height < height || shelf.height > height + height / 4 || !fits(shelf))
+        {
+            continue;
+        }
+        if (best == shelves.size() || shelf.height < shelves[best].height)
+        {
+            best = i;
+        }
+    }
+    if (best == shelves.size())
+    {
+        for (size_t i = 0; i < shelves.size(); ++i)
+        {
+            const Shelf &shelf = shelves[i];
+            if (shelf.used == 0 && shelf.height >= height && (best == shelves.size() || shelf.height < shelves[best].height))
+            {
+                best = i;
+            }
+        }
+        if (best == shelves.size())
+        {
+            return false;
+        }
+        if (shelves[best].height > height)
+        {
+            Shelf rest{shelves[best].y + height, shelves[best].height - height, {{0, pageSize}}};
+            shelves[best].height = height;
+            shelves.insert(shelves.begin() + best + 1, rest);
+        }
+    }
+
+    Shelf &shelf = shelves[best];
+    auto span = std::find_if(shelf.free.begin(), shelf.free.end(), [width](const Span &span) { return span.width >= width; });
+    x = span->x;
+    y = shelf.y;
+    span->x += width;
+    span->width -= width;
+    if (span->width == 0)
+    {
+        shelf.free.erase(span);
+    }
+    shelf.used++;
+    return true;
+}
+
+/**
+ * Returns a placed entry's area to its shelf; an emptied shelf merges with empty neighbours.
+ */
+void TextureAtlas::Release(Slot &slot)
+{
+    if (slot.page < 0)
+    {
+        return;
+    }
+    std::vector<Shelf> &shelves = pages[slot.page].shelves;
+    slot.page = -1;
+
+    auto shelf = std::find_if(shelves.begin(), shelves.end(), [&slot](const Shelf &shelf) { return shelf.y == slot.region.y; });
+    Span freed{slot.region.x, slot.region.width + kPadding};
+    auto next = std::lower_bound(shelf->free.begin(), shelf->free.end(), freed.x,
+                                 [](const Span &span, int x) { return span.x < x; });
+    next = shelf->free.insert(next, freed);
+    if (next + 1 != shelf->free.end() && next->x + next->width == (next + 1)->x)
+    {
+        next->width += (next + 1)->width;
+        shelf->free.erase(next + 1);
+    }
+    if (next != shelf->free.begin() && (next - 1)->x + (next - 1)->width == next->x)
+    {
+        (next - 1)->width += next->width;
+        shelf->free.erase(next);
+    }
+
+    if (--shelf->used == 0)
+    {
+        size_t index = shelf - shelves.begin();
+        if (index + 1 < shelves.size() && shelves[index + 1].used == 0)
+        {
+            shelves[index].height += shelves[index + 1].height;
+            shelves.erase(shelves.begin() + index + 1);
+        }
+        if (index > 0 && shelves[index - 1].used == 0)
+        {
+            shelves[index - 1].height += shelves[index].height;
+            shelves.erase(shelves.begin() + index);
+        }
+    }
+}
+
+bool TextureAtlas::AddPage()
+{
+    if (pages.size() >= maxPages)
+    {
+        return false;
+    }
+
+    // cleared so padding and unused cells stay transparent
+    std::vector<unsigned char> clear(static_cast<size_t>(pageSize) * pageSize * 4, 0);
+    Page page;
+    glGenTextures(1, &page.texture);
+    glBindTexture(GL_TEXTURE_2D, page.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pageSize, pageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, clear.data());
+    page.shelves.push_back(Shelf{0, pageSize, {{0, pageSize}}});
+    pages.push_back(std::move(page));
+    return true;
+}
+
+/**
+ * Evicts the placed entry drawn longest ago, as long as it was not drawn in the current or previous frame.
+ */
+bool TextureAtlas::EvictOne()
+{
+    Slot *oldest = nullptr;
+    for (Slot &slot : entries)
+    {
+        if (slot.alive && slot.page >= 0 && slot.lastUsed + 1 < frame && (!oldest || slot.lastUsed < oldest->lastUsed))
+        {
+            oldest = &slot;
+        }
+    }
+    if (!oldest)
+    {
+        return false;
+    }
+    Release(*oldest);
+    evictions++;
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief 작은 아이콘들을 몇 장의 큰 텍스처에 모아 담는 런타임 아틀라스
+ *
+ * Entries are packed into square pages with a shelf allocator: each page is
+ * cut into horizontal shelves and icons of a similar height share a shelf.
+ * Icons drawn from one page share a texture, so ImGui merges them into a
+ * single draw call. When every page is full, the entries drawn longest ago
+ * are evicted. Shelves emptied by eviction or Destroy() are merged with
+ * their empty neighbours and cut again for whatever height comes next.
+ * Pixels are never moved, entries keep their place until evicted.
+ *
+ * Every call needs the GL context, i.e. the render thread.
+ */
+class TextureAtlas {
+public:
+    using Entry = uint32_t;
+
+    struct Region {
+        GLuint texture = 0;
+        int x = 0, y = 0, width = 0, height = 0;
+        float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+    };
+    struct Stats {
+        size_t pages = 0;
+        size_t entries = 0;
+        size_t placed = 0;
+        size_t evictions = 0;
+        size_t usedPixels = 0;      // by placed entries, padding excluded
+        size_t pagePixels = 0;
+    };
+
+    explicit TextureAtlas(int pageSize = 1024, size_t maxPages = 4);
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    /**
+     * @brief New entry with no pixels yet, drawn as a transparent cell until Place() succeeds.
+     */
+    Entry Create();
+    void Destroy(Entry entry);
+
+    /**
+     * @brief Reserves a width x height area for entry, evicting entries that were not drawn last frame if needed.
+     */
+    bool Place(Entry entry, int width, int height);
+    bool IsPlaced(Entry entry) const { return entries[entry].page >= 0; }
+
+    /**
+     * @brief Region to draw entry with, also marks it as drawn this frame.
+     */
+    const Region& Use(Entry entry);
+
+    /**
+     * @brief Advances the frame counter eviction compares against, once per frame.
+     */
+    void NextFrame() { ++frame; }
+
+    /**
+     * @brief Deletes the page textures while the GL context is still alive.
+     */
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Span {
+        int x;
+        int width;
+    };
+    struct Shelf {
+        int y;
+        int height;
+        std::vector<Span> free;     // sorted by x, never adjacent
+        int used = 0;               // entries on the shelf
+    };
+    struct Page {
+        GLuint texture = 0;
+        std::vector<Shelf> shelves; // sorted by y, covering the page from the top
+    };
+    struct Slot {
+        int page = -1;              // -1 while not placed
+        Region region;
+        uint64_t lastUsed = 0;
+        bool alive = false;
+    };
+
+    bool Allocate(size_t page, int width, int height, int& x, int& y);
+    void Release(Slot& slot);
+    bool AddPage();
+    bool EvictOne();
+
+    int pageSize;
+    size_t maxPages;
+    std::vector<Page> pages;
+    std::vector<Slot> entries;
+    std::vector<Entry> freeEntries;
+    Region placeholder;
+    uint64_t frame = 1;
+    size_t evictions = 0;
+};
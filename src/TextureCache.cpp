@@ -0,0 +1,129 @@
+#include "TextureCache.h"
+#include <iostream>
+
+TextureCache::TextureCache(TextureLoader& loader, size_t budgetBytes)
+    : loader(loader), budgetBytes(budgetBytes)
+{
+}
+
+GLuint TextureCache::Get(const std::string &url, int targetWidth, int targetHeight, const HttpTransport::CancelToken &cancel)
+{
+    std::string key = url;
+    if (targetWidth > 0 && targetHeight > 0)
+    {
+        key += "#" + std::to_string(targetWidth) + "x" + std::to_string(targetHeight);
+    }
+
+    auto it = entries.find(key);
+    if (it == entries.end())
+    {
+        ++misses;
+        recency.push_front(key);
+        Entry entry;
+        entry.texture = loader.Request(url, targetWidth, targetHeight);
+        entry.recent = recency.begin();
+        it = entries.emplace(key, entry).first;
+        ++unsized;
+    }
+    else if (it->second.lastUsed != frame)
+    {
+        if (it->second.lastUsed + 1 < frame)
+        {
+            ++hits;
+        }
+        recency.splice(recency.begin(), recency, it->second.recent);
+    }
+    it->second.lastUsed = frame;
+    it->second.cancel = cancel;
+    return it->second.texture;
+}
+
+void TextureCache::NextFrame()
+{
+    if (unsized > 0)
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            Entry &entry = it->second;
+            if (!entry.sized && entry.cancel.IsCancelled() && !loader.IsReady(entry.texture))
+            {
+                // no longer wanted while loading, releasing it cancels the load; drawn again it is requested again
+                loader.Release(entry.texture);
+                recency.erase(entry.recent);
+                it = entries.erase(it);
+                --unsized;
+                continue;
+            }
+            if (entry.sized || !loader.IsReady(entry.texture))
+            {
+                ++it;
+                continue;
+            }
+            int width = 0, height = 0;
+            entry.bytes = loader.GetSize(entry.texture, width, height) ? static_cast<size_t>(width) * height * 4 : 4;  // failed loads keep the 1x1 placeholder
+            entry.sized = true;
+            residentBytes += entry.bytes;
+            --unsized;
+            ++it;
+        }
+    }
+
+    ++frame;
+    size_t evicted = 0;
+    while (residentBytes > budgetBytes && !recency.empty())
+    {
+        if (entries.at(recency.back()).lastUsed + 1 >= frame)
+        {
+            break;  // everything left was drawn last frame
+        }
+        Evict(recency.back());
+        ++evicted;
+    }
+    if (evicted > 0)
+    {
+        std::cout << "[texture] evicted " << evicted << ", resident " << residentBytes / 1024 << " of " << budgetBytes / 1024
+                  << " KiB, " << hits << " hits, " << misses << " misses, " << evictions << " evictions" << std::endl;
+    }
+}
+
+void TextureCache::Clear()
+{
+    for (auto &pair : entries)
+    {
+        loader.Release(pair.second.texture);
+    }
+    entries.clear();
+    recency.clear();
+    unsized = 0;
+    residentBytes = 0;
+}
+
+TextureCache::Stats TextureCache::GetStats() const
+{
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.entries = entries.size();
+    stats.residentBytes = residentBytes;
+    stats.budgetBytes = budgetBytes;
+    return stats;
+}
+
+void TextureCache::Evict(const std::string &key)
+{
+    auto it = entries.find(key);
+    Entry &entry = it->second;
+    if (entry.sized)
+    {
+        residentBytes -= entry.bytes;
+    }
+    else
+    {
+        --unsized;  // still loading, the loader drops the image when it arrives
+    }
+    loader.Release(entry.texture);
+    recency.erase(entry.recent);
+    entries.erase(it);
+    ++evictions;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include "TextureLoader.h"
+
+/**
+ * @brief GPU 메모리 예산 안에서 가장 오래 그려지지 않은 텍스처부터 내보내는 URL 단위 텍스처 캐시
+ *
+ * Get() is called every frame a texture is drawn. Once per frame NextFrame()
+ * adds up the bytes of the loaded textures (width x height x 4, there are no
+ * mipmaps) and, while they exceed the budget, releases the ones drawn longest
+ * ago. Textures drawn in the previous frame are never evicted, so a screen that
+ * needs more than the budget goes over it instead of flickering. An evicted
+ * texture is requested again the next time it is drawn, usually from the
+ * loader's decoded image cache.
+ *
+ * A texture drawn with a CancelToken is dropped by NextFrame() if the token is
+ * cancelled before it has loaded, which aborts its download unless something
+ * else is waiting for the same image.
+ *
+ * Every call needs the GL context, i.e. the render thread.
+ */
+class TextureCache {
+public:
+    struct Stats {
+        size_t hits = 0;            // drawn again after at least a frame unused, still resident
+        size_t misses = 0;          // requested from the loader, first time or after eviction
+        size_t evictions = 0;
+        size_t entries = 0;
+        size_t residentBytes = 0;
+        size_t budgetBytes = 0;
+    };
+
+    explicit TextureCache(TextureLoader& loader, size_t budgetBytes = 128u << 20);
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * @brief Texture of url to draw this frame, a transparent placeholder until it is loaded.
+     *
+     * A target size has the image decoded at the size it is drawn at, each size is cached on its own.
+     * cancel is the token of the last Get() that counts, typically tied to what the screen shows.
+     */
+    GLuint Get(const std::string& url, int targetWidth = 0, int targetHeight = 0, const HttpTransport::CancelToken& cancel = {});
+
+    /**
+     * @brief Evicts down to the budget and advances the frame counter, once per frame before drawing.
+     */
+    void NextFrame();
+
+    void SetBudget(size_t bytes) { budgetBytes = bytes; }
+
+    /**
+     * @brief Releases every texture while the GL context is still alive.
+     */
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        GLuint texture = 0;
+        uint64_t lastUsed = 0;
+        size_t bytes = 0;
+        bool sized = false;         // bytes is known, the load finished
+        HttpTransport::CancelToken cancel;
+        std::list<std::string>::iterator recent;
+    };
+
+    void Evict(const std::string& key);
+
+    TextureLoader& loader;
+    size_t budgetBytes;
+    std::unordered_map<std::string, Entry> entries;  // by url, with the target size appended when there is one
+    std::list<std::string> recency;  // most recently drawn first
+    size_t unsized = 0;
+    uint64_t frame = 1;
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t residentBytes = 0;
+};
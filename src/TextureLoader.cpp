@@ -0,0 +1,731 @@
+#include "TextureLoader.h"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include "ImageDecoder.h"
+
+// Buffer object entry points are past OpenGL 1.1, so they are looked up at run time
+#ifndef APIENTRY
+#ifdef _WIN32
+#define APIENTRY __stdcall
+#else
+#define APIENTRY
+#endif
+#endif
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#define GL_STREAM_DRAW 0x88E0
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+
+using GenBuffersProc = void(APIENTRY *)(GLsizei, GLuint *);
+using BindBufferProc = void(APIENTRY *)(GLenum, GLuint);
+using BufferDataProc = void(APIENTRY *)(GLenum, ptrdiff_t, const void *, GLenum);
+using MapBufferRangeProc = void *(APIENTRY *)(GLenum, ptrdiff_t, ptrdiff_t, GLbitfield);
+using UnmapBufferProc = GLboolean(APIENTRY *)(GLenum);
+
+static GenBuffersProc glGenBuffersProc = nullptr;
+static BindBufferProc glBindBufferProc = nullptr;
+static BufferDataProc glBufferDataProc = nullptr;
+static MapBufferRangeProc glMapBufferRangeProc = nullptr;
+static UnmapBufferProc glUnmapBufferProc = nullptr;
+
+static std::string FlightKey(const std::string &url, int targetWidth, int targetHeight)
+{
+    return url + "#" + std::to_string(targetWidth) + "x" + std::to_string(targetHeight);
+}
+
+TextureLoader::TextureLoader(HttpTransport &transport, const std::filesystem::path &imageCacheDirectory, size_t workerCount)
+    : transport(transport), imageCache(imageCacheDirectory)
+{
+    for (size_t i = 0; i < std::max<size_t>(workerCount, 1); ++i)
+    {
+        workers.emplace_back(&TextureLoader::Run, this);
+    }
+}
+
+TextureLoader::~TextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(stagingMutex);  // a worker waiting for buffer room sees stopping
+    }
+    stagingReady.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    for (auto &image : images)
+    {
+        FreeImagePixels(image.pixels);
+    }
+    FreeImagePixels(current.pixels);
+}
+
+GLuint TextureLoader::Request(const std::string &url, int targetWidth, int targetHeight)
+{
+    static const unsigned char transparent[4] = {0, 0, 0, 0};
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent);
+
+    uint64_t ticket = nextTicket++;
+    std::string key = FlightKey(url, targetWidth, targetHeight);
+    pending[texture] = {ticket, key};
+    Queue({texture, kNoIcon, ticket}, key, url, targetWidth, targetHeight);
+    return texture;
+}
+
+TextureLoader::Icon TextureLoader::RequestIcon(const std::string &url)
+{
+    Icon icon = atlas.Create();
+    if (icon >= icons.size())
+    {
+        icons.resize(icon + 1);
+    }
+    icons[icon] = IconRecord{url, nextTicket++};
+    ++iconsLoading;
+    Queue({0, icon, icons[icon].ticket}, FlightKey(url, 0, 0), url);
+    return icon;
+}
+
+const TextureAtlas::Region &TextureLoader::DrawIcon(Icon icon)
+{
+    IconRecord &record = icons[icon];
+    if (record.loaded && !atlas.IsPlaced(icon))
+    {
+        record.loaded = false;
+        record.ticket = nextTicket++;
+        ++iconsLoading;
+        Queue({0, icon, record.ticket}, FlightKey(record.url, 0, 0), record.url);
+    }
+    return atlas.Use(icon);
+}
+
+void TextureLoader::ReleaseIcon(Icon icon)
+{
+    if (icons[icon].ticket != 0)
+    {
+        Detach(FlightKey(icons[icon].url, 0, 0), icons[icon].ticket);
+        --iconsLoading;
+    }
+    icons[icon] = IconRecord{};
+    atlas.Destroy(icon);
+}
+
+void TextureLoader::Queue(const Target &target, const std::string &key, const std::string &url, int targetWidth, int targetHeight)
+{
+    ++requested;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        auto it = flights.find(key);
+        if (it != flights.end() && !it->second.cancel.IsCancelled())
+        {
+            it->second.targets.push_back(target);
+            ++coalesced;
+            // a prefetch still waiting is wanted now, it moves up to the requests
+            uint64_t id = it->second.id;
+            auto prefetch = std::find_if(prefetches.begin(), prefetches.end(), [id](const Job &job) { return job.flight == id; });
+            if (prefetch == prefetches.end())
+            {
+                return;  // queued or running already
+            }
+            jobs.push_back(std::move(*prefetch));
+            jobs.back().prefetch = false;
+            jobs.back().priority = HttpTransport::Priority::Visible;
+            prefetches.erase(prefetch);
+        }
+        else
+        {
+            // replaces a cancelled flight that is still running, its worker finds the id changed
+            Flight flight{nextFlight++, {target}, HttpTransport::CancelToken::Create()};
+            jobs.push_back({flight.id, key, url, targetWidth, targetHeight, false, flight.cancel, HttpTransport::Priority::Visible});
+            flights[key] = std::move(flight);
+        }
+    }
+    jobReady.notify_one();
+}
+
+/**
+ * Takes a released texture or icon off its flight, cancelling the flight once nothing is waiting for it.
+ */
+void TextureLoader::Detach(const std::string &key, uint64_t ticket)
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    auto it = flights.find(key);
+    if (it == flights.end())
+    {
+        return;  // loaded already, Upload() drops the image
+    }
+    std::vector<Target> &targets = it->second.targets;
+    auto target = std::find_if(targets.begin(), targets.end(), [ticket](const Target &target) { return target.ticket == ticket; });
+    if (target == targets.end())
+    {
+        return;
+    }
+    targets.erase(target);
+    if (targets.empty())
+    {
+        it->second.cancel.Cancel();
+        ++cancelled;
+    }
+}
+
+void TextureLoader::Release(GLuint texture)
+{
+    if (texture == 0)
+    {
+        return;
+    }
+    // GL may hand the name out again, the ticket keeps a late image from landing in the new texture
+    auto it = pending.find(texture);
+    if (it != pending.end())
+    {
+        Detach(it->second.key, it->second.ticket);
+        pending.erase(it);
+    }
+    sizes.erase(texture);
+    glDeleteTextures(1, &texture);
+}
+
+bool TextureLoader::IsReady(GLuint texture) const
+{
+    return texture != 0 && pending.find(texture) == pending.end();
+}
+
+bool TextureLoader::GetSize(GLuint texture, int &width, int &height) const
+{
+    auto it = sizes.find(texture);
+    if (it == sizes.end() || !IsReady(texture))
+    {
+        return false;
+    }
+    width = it->second.first;
+    height = it->second.second;
+    return true;
+}
+
+/**
+ * False once the texture or icon was released, or requested again, after its image was queued.
+ */
+bool TextureLoader::IsLive(const Target &target) const
+{
+    if (target.icon != kNoIcon)
+    {
+        return target.icon < icons.size() && icons[target.icon].ticket == target.ticket;
+    }
+    auto it = pending.find(target.texture);
+    return it != pending.end() && it->second.ticket == target.ticket;
+}
+
+/**
+ * Ends the load of a live texture or icon, whether it was uploaded or failed.
+ */
+void TextureLoader::Settle(const Target &target, bool loaded)
+{
+    if (target.icon != kNoIcon)
+    {
+        icons[target.icon].ticket = 0;
+        icons[target.icon].loaded = loaded;
+        --iconsLoading;
+    }
+    else
+    {
+        pending.erase(target.texture);
+    }
+}
+
+void TextureLoader::Upload(double budgetMs, size_t budgetBytes)
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    atlas.NextFrame();
+    bool staged = PreparePixelBuffers();
+    size_t stagedFrameBytes = 0;
+
+    // take the buffer the workers filled since the last frame, unless one is still copying into it
+    std::vector<Image> ready;
+    if (staged)
+    {
+        std::lock_guard<std::mutex> lock(stagingMutex);
+        if (staging && stagingWriters == 0 && !stagedImages.empty())
+        {
+            ready.swap(stagedImages);
+            staging = nullptr;
+            stagingUsed = 0;
+        }
+    }
+    for (const Image &image : ready)
+    {
+        // the same band of the buffer goes to every texture and icon that joined the load
+        size_t size = static_cast<size_t>(image.width) * image.height * 4;
+        for (const Target &target : image.targets)
+        {
+            if (!IsLive(target))
+            {
+                continue;  // released while loading
+            }
+            GLuint texture = target.texture;
+            int targetX = 0, targetY = 0;
+            if (target.icon != kNoIcon)
+            {
+                if (!atlas.IsPlaced(target.icon) && !atlas.Place(target.icon, image.width, image.height))
+                {
+                    std::cerr << "No room in the icon atlas for " << icons[target.icon].url << std::endl;
+                    Settle(target, false);
+                    continue;
+                }
+                const TextureAtlas::Region &region = atlas.Use(target.icon);
+                texture = region.texture;
+                targetX = region.x;
+                targetY = region.y;
+            }
+            else
+            {
+                // storage is allocated before the buffer is bound, it would be read as the source otherwise
+                glBindTexture(GL_TEXTURE_2D, texture);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                sizes[texture] = {image.width, image.height};
+            }
+            bands.push_back({texture, targetX, targetY, image.height, image.width, image.offset});
+            Settle(target, true);
+            ++uploaded;
+            stagedFrameBytes += size;
+            uploadedBytes += size;
+        }
+    }
+    if (!ready.empty())
+    {
+        // the bands are read from the buffer once it is unmapped, the copy to the texture runs asynchronously
+        glBindBufferProc(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[frame % 2]);
+        glUnmapBufferProc(GL_PIXEL_UNPACK_BUFFER);
+        for (const Band &band : bands)
+        {
+            glBindTexture(GL_TEXTURE_2D, band.texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, band.x, band.y, band.width, band.rows, GL_RGBA, GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void *>(band.offset));
+        }
+        glBindBufferProc(GL_PIXEL_UNPACK_BUFFER, 0);
+        bands.clear();
+        ++frame;
+    }
+    // the same pixels go to every texture and icon that joined the load, then they are freed
+    auto nextTarget = [this]()
+    {
+        current.uploadedRows = 0;
+        if (++current.next == current.targets.size())
+        {
+            FreeImagePixels(current.pixels);
+            current = Image{};
+        }
+    };
+
+    // images that were not staged are copied from client memory, within the budget
+    size_t bytes = 0;
+    for (bool first = true;; first = false)
+    {
+        if (!first && (bytes >= budgetBytes || std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= budgetMs))
+        {
+            break;
+        }
+
+        if (current.targets.empty())
+        {
+            std::lock_guard<std::mutex> lock(imageMutex);
+            if (images.empty())
+            {
+                break;
+            }
+            current = std::move(images.front());
+            images.pop_front();
+        }
+
+        const Target &target = current.targets[current.next];
+        bool live = IsLive(target);
+        bool loaded = current.pixels != nullptr;
+        if (live && loaded && target.icon != kNoIcon && !atlas.IsPlaced(target.icon))
+        {
+            current.uploadedRows = 0;  // not placed yet, or evicted between bands
+            if (!atlas.Place(target.icon, current.width, current.height))
+            {
+                std::cerr << "No room in the icon atlas for " << icons[target.icon].url << std::endl;
+                loaded = false;
+            }
+        }
+        if (!live || !loaded)
+        {
+            if (live)
+            {
+                Settle(target, false);  // failed, keep the placeholder
+            }
+            nextTarget();  // otherwise released while loading
+            continue;
+        }
+
+        size_t rowBytes = static_cast<size_t>(current.width) * 4;
+        size_t room = budgetBytes > bytes ? budgetBytes - bytes : 0;
+        int rows = std::min(current.height - current.uploadedRows, static_cast<int>(room / rowBytes));
+        if (rows == 0)
+        {
+            if (!first)
+            {
+                break;
+            }
+            rows = 1;  // a row wider than the whole budget
+        }
+
+        GLuint texture = target.texture;
+        int targetX = 0, targetY = 0;
+        if (target.icon != kNoIcon)
+        {
+            const TextureAtlas::Region &region = atlas.Use(target.icon);
+            texture = region.texture;
+            targetX = region.x;
+            targetY = region.y;
+        }
+        else if (current.uploadedRows == 0)
+        {
+            // rows not sent yet are undefined for the frame or two until they arrive
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, current.width, current.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            sizes[texture] = {current.width, current.height};
+        }
+
+        const unsigned char *source = current.pixels + rowBytes * current.uploadedRows;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, targetX, targetY + current.uploadedRows, current.width, rows, GL_RGBA, GL_UNSIGNED_BYTE, source);
+
+        size_t size = rowBytes * rows;
+        bytes += size;
+        uploadedBytes += size;
+        current.uploadedRows += rows;
+        if (current.uploadedRows == current.height)
+        {
+            Settle(target, true);
+            ++uploaded;
+            nextTarget();
+        }
+    }
+
+    if (staged)
+    {
+        std::lock_guard<std::mutex> lock(stagingMutex);
+        if (!staging)
+        {
+            // the workers fill the other buffer for the next frame, its transfers were issued a frame ago
+            glBindBufferProc(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[frame % 2]);
+            staging = static_cast<unsigned char *>(glMapBufferRangeProc(GL_PIXEL_UNPACK_BUFFER, 0, kPixelBufferBytes,
+                                                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+            glBindBufferProc(GL_PIXEL_UNPACK_BUFFER, 0);
+            if (!staging)
+            {
+                std::cerr << "Failed to map a pixel buffer, uploading textures from client memory" << std::endl;
+                pixelBufferState = -1;
+            }
+            stagingReady.notify_all();
+        }
+    }
+
+    bytes += stagedFrameBytes;
+    if (bytes > 0)
+    {
+        lastFrameMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        lastFrameBytes = bytes;
+        worstFrameMs = std::max(worstFrameMs, lastFrameMs);
+
+        // at most a line a second while images arrive, and one for every frame over budget
+        reportBytes += bytes;
+        ++reportFrames;
+        auto now = Clock::now();
+        bool overBudget = lastFrameMs > budgetMs;
+        if (overBudget || now - lastReport >= std::chrono::seconds(1))
+        {
+            std::cout << "[texture] uploaded " << reportBytes / 1024 << " KiB in " << reportFrames << " frames, last "
+                      << lastFrameBytes / 1024 << " KiB in " << lastFrameMs << " ms" << (overBudget ? ", over budget" : "") << std::endl;
+            lastReport = now;
+            reportBytes = 0;
+            reportFrames = 0;
+        }
+    }
+}
+
+/**
+ * Creates the staging buffers on first use, once the GL context is current. Needs GL 3.0 or ARB_map_buffer_range.
+ */
+bool TextureLoader::PreparePixelBuffers()
+{
+    if (pixelBufferState == 0)
+    {
+        glGenBuffersProc = reinterpret_cast<GenBuffersProc>(glfwGetProcAddress("glGenBuffers"));
+        glBindBufferProc = reinterpret_cast<BindBufferProc>(glfwGetProcAddress("glBindBuffer"));
+        glBufferDataProc = reinterpret_cast<BufferDataProc>(glfwGetProcAddress("glBufferData"));
+        glMapBufferRangeProc = reinterpret_cast<MapBufferRangeProc>(glfwGetProcAddress("glMapBufferRange"));
+        glUnmapBufferProc = reinterpret_cast<UnmapBufferProc>(glfwGetProcAddress("glUnmapBuffer"));
+        if (!glGenBuffersProc || !glBindBufferProc || !glBufferDataProc || !glMapBufferRangeProc || !glUnmapBufferProc)
+        {
+            std::cerr << "Pixel buffer objects are not supported, uploading textures from client memory" << std::endl;
+            std::lock_guard<std::mutex> lock(stagingMutex);
+            pixelBufferState = -1;
+            stagingReady.notify_all();
+            return false;
+        }
+
+        glGenBuffersProc(2, pixelBuffers);
+        for (GLuint buffer : pixelBuffers)
+        {
+            glBindBufferProc(GL_PIXEL_UNPACK_BUFFER, buffer);
+            glBufferDataProc(GL_PIXEL_UNPACK_BUFFER, kPixelBufferBytes, nullptr, GL_STREAM_DRAW);
+        }
+        glBindBufferProc(GL_PIXEL_UNPACK_BUFFER, 0);
+        std::lock_guard<std::mutex> lock(stagingMutex);
+        pixelBufferState = 1;
+    }
+    return pixelBufferState > 0;
+}
+
+/**
+ * Copies a decoded image into the pixel buffer mapped for the next frame and frees its pixels, so Upload() only
+ * unmaps the buffer. Waits for the next frame's buffer when this one is full. False when pixel buffers are not
+ * supported or the image is larger than one, it is then uploaded from client memory.
+ */
+bool TextureLoader::Stage(Image &image)
+{
+    size_t size = static_cast<size_t>(image.width) * image.height * 4;
+    if (size > kPixelBufferBytes)
+    {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(stagingMutex);
+    stagingReady.wait(lock, [&]()
+                      { return stopping || pixelBufferState < 0 || (staging && stagingUsed + size <= kPixelBufferBytes); });
+    if (stopping || pixelBufferState < 0)
+    {
+        return false;
+    }
+    unsigned char *destination = staging + stagingUsed;
+    image.offset = stagingUsed;
+    stagingUsed += size;
+    ++stagingWriters;
+    lock.unlock();
+
+    std::memcpy(destination, image.pixels, size);
+    FreeImagePixels(image.pixels);
+    image.pixels = nullptr;
+    image.staged = true;
+    stagedBytes += size;
+
+    lock.lock();
+    --stagingWriters;
+    stagedImages.push_back(std::move(image));
+    return true;
+}
+
+TextureLoader::Stats TextureLoader::GetStats() const
+{
+    Stats stats;
+    stats.requested = requested;
+    stats.uploaded = uploaded;
+    stats.failed = failed.load();
+    stats.pending = pending.size() + iconsLoading;
+    stats.uploadedBytes = uploadedBytes;
+    stats.stagedBytes = stagedBytes.load();
+    stats.decodeMs = decodeMicroseconds.load() / 1000.0;
+    ImageCache::Stats cacheStats = imageCache.GetStats();
+    stats.cacheHits = cacheStats.hits;
+    stats.cacheLoadMs = cacheStats.loadMs;
+    stats.prefetched = prefetched.load();
+    stats.prefetchesDropped = prefetchesDropped;
+    stats.coalesced = coalesced;
+    stats.cancelled = cancelled;
+    stats.lastFrameMs = lastFrameMs;
+    stats.lastFrameBytes = lastFrameBytes;
+    stats.worstFrameMs = worstFrameMs;
+    return stats;
+}
+
+void TextureLoader::Prefetch(const std::vector<PrefetchItem> &items)
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        prefetchesDropped += prefetches.size();
+        for (const Job &job : prefetches)
+        {
+            // none of them was requested, that would have moved it to jobs
+            auto it = flights.find(job.key);
+            if (it != flights.end() && it->second.id == job.flight)
+            {
+                flights.erase(it);
+            }
+        }
+        prefetches.clear();
+        for (size_t i = 0; i < items.size() && prefetches.size() < kMaxQueuedPrefetches; ++i)
+        {
+            std::string key = FlightKey(items[i].url, items[i].targetWidth, items[i].targetHeight);
+            if (flights.find(key) != flights.end())
+            {
+                continue;  // loading already
+            }
+            Flight flight{nextFlight++, {}, HttpTransport::CancelToken::Create()};
+            prefetches.push_back({flight.id, key, items[i].url, items[i].targetWidth, items[i].targetHeight, true, flight.cancel,
+                                  items[i].priority});
+            flights[key] = std::move(flight);
+        }
+    }
+    jobReady.notify_all();
+}
+
+/**
+ * Pixels of a job, from the image cache or fetched, decoded and stored there. Null when the load failed or was
+ * cancelled, and for a prefetch of an image cached already, which sets skipped.
+ */
+unsigned char *TextureLoader::Load(const Job &job, int &width, int &height, bool &skipped)
+{
+    if (job.cancel.IsCancelled())
+    {
+        return nullptr;
+    }
+    if (job.prefetch && imageCache.Contains(job.url, job.targetWidth, job.targetHeight))
+    {
+        skipped = true;
+        return nullptr;
+    }
+
+    // seen before, at this size: no network and no JPEG or PNG decoder
+    unsigned char *pixels = job.prefetch ? nullptr : imageCache.Load(job.url, job.targetWidth, job.targetHeight, width, height);
+    if (pixels)
+    {
+        return pixels;
+    }
+
+    // poll so shutdown does not wait for a slow transfer; cancelling the load aborts the transfer
+    HttpTransport::Priority priority = job.priority;
+    auto future = transport.Fetch(job.url, {}, nullptr, job.cancel, priority);
+    while (future.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+    {
+        if (stopping)
+        {
+            return nullptr;
+        }
+        if (priority != HttpTransport::Priority::Visible && IsRequested(job))
+        {
+            // raised in place, it is not preempted any more and no second fetch copies its body
+            priority = HttpTransport::Priority::Visible;
+            transport.Raise(job.url, priority);
+        }
+    }
+    HttpTransport::Response response = future.get();
+    if (job.cancel.IsCancelled())
+    {
+        return nullptr;  // not decoded, nothing is waiting for it
+    }
+    if (!response.ok || response.status != 200)
+    {
+        std::cerr << "Failed to download image: " << job.url << std::endl;
+        return nullptr;
+    }
+
+    auto decodeStart = std::chrono::steady_clock::now();
+    pixels = DecodeImage(reinterpret_cast<const unsigned char *>(response.body.data()), response.body.size(),
+                         job.targetWidth, job.targetHeight, width, height);
+    decodeMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - decodeStart).count();
+    if (!pixels)
+    {
+        std::cerr << "Failed to decode image: " << job.url << std::endl;
+        return nullptr;
+    }
+    if (imageCache.Store(job.url, job.targetWidth, job.targetHeight, pixels, width, height) && job.prefetch)
+    {
+        ++prefetched;
+    }
+    return pixels;
+}
+
+/**
+ * True once a texture or icon joined the flight of a prefetch.
+ */
+bool TextureLoader::IsRequested(const Job &job)
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    auto it = flights.find(job.key);
+    return it != flights.end() && it->second.id == job.flight && !it->second.targets.empty();
+}
+
+void TextureLoader::Run()
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this]()
+                          { return stopping || !jobs.empty() || (!prefetches.empty() && runningPrefetches < kMaxRunningPrefetches); });
+            if (stopping)
+            {
+                return;
+            }
+            std::deque<Job> &queue = jobs.empty() ? prefetches : jobs;
+            job = std::move(queue.front());
+            queue.pop_front();
+            if (job.prefetch)
+            {
+                ++runningPrefetches;
+            }
+        }
+
+        Image image;
+        bool skipped = false;
+        image.pixels = Load(job, image.width, image.height, skipped);
+        {
+            // everything that joined the flight until now gets the image, later requests start a new one
+            std::lock_guard<std::mutex> lock(jobMutex);
+            auto it = flights.find(job.key);
+            if (it != flights.end() && it->second.id == job.flight)
+            {
+                image.targets = std::move(it->second.targets);
+                flights.erase(it);
+            }
+            if (job.prefetch)
+            {
+                --runningPrefetches;
+            }
+        }
+        if (job.prefetch)
+        {
+            jobReady.notify_one();
+        }
+
+        if (image.targets.empty())
+        {
+            FreeImagePixels(image.pixels);  // a prefetch nobody requested, or cancelled
+            continue;
+        }
+        if (skipped)
+        {
+            // a prefetch of a cached image, requested while it was being checked
+            image.pixels = imageCache.Load(job.url, job.targetWidth, job.targetHeight, image.width, image.height);
+        }
+        if (!image.pixels)
+        {
+            ++failed;
+        }
+        else if (Stage(image))
+        {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(imageMutex);
+        images.push_back(std::move(image));
+    }
+}
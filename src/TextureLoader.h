@@ -0,0 +1,251 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include "HttpTransport.h"
+#include "TextureAtlas.h"
+#include "ImageCache.h"
+
+/**
+ * @brief 이미지 다운로드 / 디코딩은 작업 스레드에서, GL 업로드만 렌더 스레드에서 처리하는 텍스처 로더
+ *
+ * Request() hands out a texture name at once, holding a transparent 1x1
+ * placeholder. Workers fetch and decode the image, and Upload(), called once
+ * per frame, sends finished images to their textures. The render thread never
+ * waits on the network, on a decoder or on a pixel copy.
+ *
+ * Two pixel buffer objects are used on alternate frames. Workers copy decoded
+ * images into the one mapped for the next frame, and Upload() only unmaps it
+ * and issues glTexSubImage2D, which returns without waiting for the transfer;
+ * the buffer being written was last read a frame ago. An image larger than a
+ * buffer, or every image without pixel buffer support, is uploaded from client
+ * memory in bands of rows until the frame's time or byte budget is spent, a
+ * splash that does not fit continues next frame.
+ * Icons requested with RequestIcon() are packed into a shared TextureAtlas.
+ * Decoded images are kept in an ImageCache on disk, so an evicted texture or
+ * a restart loads them again without the network or an image decoder.
+ *
+ * Requests download at visible priority, prefetches at their own, lower one.
+ * Loads are single-flight: textures and icons requested for an image, at a
+ * size, that is already loading join that load, one transfer and one decode
+ * fill all of them. A load is cancelled once everything that requested it is
+ * released, its transfer is aborted and its decode skipped.
+ */
+class TextureLoader {
+public:
+    static constexpr size_t kPixelBufferBytes = 4u << 20;
+
+    using Icon = TextureAtlas::Entry;
+    static constexpr Icon kNoIcon = UINT32_MAX;
+
+    // prefetches waiting at most, and running at most so they never hold up every worker
+    static constexpr size_t kMaxQueuedPrefetches = 16;
+    static constexpr size_t kMaxRunningPrefetches = 2;
+
+    struct PrefetchItem {
+        std::string url;
+        int targetWidth = 0;
+        int targetHeight = 0;
+        HttpTransport::Priority priority = HttpTransport::Priority::Prefetch;  // of its download
+    };
+
+    struct Stats {
+        size_t requested = 0;
+        size_t uploaded = 0;
+        size_t failed = 0;          // download or decode failed, the placeholder stays
+        size_t pending = 0;         // requested but not uploaded yet
+        size_t uploadedBytes = 0;
+        double decodeMs = 0.0;      // summed over the workers
+        size_t cacheHits = 0;       // loaded already decoded from the image cache
+        double cacheLoadMs = 0.0;
+        size_t prefetched = 0;      // decoded into the image cache ahead of a request
+        size_t prefetchesDropped = 0;  // replaced before a worker got to them
+        size_t coalesced = 0;       // requests that joined a load already in flight
+        size_t cancelled = 0;       // loads abandoned because everything that requested them was released
+        size_t stagedBytes = 0;     // copied into the pixel buffers by the workers
+        double lastFrameMs = 0.0;   // time spent in the last Upload() that had work
+        size_t lastFrameBytes = 0;  // uploaded by that call
+        double worstFrameMs = 0.0;
+    };
+
+    TextureLoader(HttpTransport& transport, const std::filesystem::path& imageCacheDirectory, size_t workerCount = 4);
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    /**
+     * @brief Creates a placeholder texture and queues url to be loaded into it. Render thread only.
+     *
+     * With a target size the image is decoded at the size it is drawn at instead of its full resolution.
+     */
+    GLuint Request(const std::string& url, int targetWidth = 0, int targetHeight = 0);
+
+    /**
+     * @brief Deletes a texture from Request(), cancelling its load if nothing else is waiting for it.
+     */
+    void Release(GLuint texture);
+
+    bool IsReady(GLuint texture) const;
+
+    /**
+     * @brief Size of the image loaded into texture, false until it is ready.
+     */
+    bool GetSize(GLuint texture, int& width, int& height) const;
+
+    /**
+     * @brief Like Request(), but the image is packed into the icon atlas instead of a texture of its own.
+     */
+    Icon RequestIcon(const std::string& url);
+
+    /**
+     * @brief Atlas region to draw icon with this frame. An icon evicted from the atlas is requested again.
+     */
+    const TextureAtlas::Region& DrawIcon(Icon icon);
+    void ReleaseIcon(Icon icon);
+    TextureAtlas& GetAtlas() { return atlas; }
+
+    /**
+     * @brief Replaces the queued prefetches with items, most likely first. Render thread only.
+     *
+     * Prefetches are only decoded into the image cache, they get no texture and
+     * no GPU memory, and workers take them only when no request is waiting. A
+     * later Request() for the same url and size then loads without the network.
+     * Items already cached are skipped, prefetches already running finish.
+     */
+    void Prefetch(const std::vector<PrefetchItem>& items);
+
+    /**
+     * @brief Uploads finished images. Render thread only.
+     *
+     * Everything the workers staged since the last call is sent. Images uploaded
+     * from client memory stop once budgetMs or budgetBytes is used up, at least
+     * one band of rows per call so a large image always makes progress.
+     */
+    void Upload(double budgetMs = 4.0, size_t budgetBytes = kPixelBufferBytes);
+
+    Stats GetStats() const;
+
+private:
+    struct Target {
+        GLuint texture;             // 0 for an icon
+        Icon icon;
+        uint64_t ticket;
+    };
+    struct Flight {
+        uint64_t id;
+        std::vector<Target> targets;  // empty for a prefetch nobody requested
+        HttpTransport::CancelToken cancel;
+    };
+    struct Job {
+        uint64_t flight;
+        std::string key;            // of the flight
+        std::string url;
+        int targetWidth = 0;        // 0 for full size
+        int targetHeight = 0;
+        bool prefetch = false;      // into the image cache only, unless requested meanwhile
+        HttpTransport::CancelToken cancel;
+        HttpTransport::Priority priority = HttpTransport::Priority::Visible;
+    };
+    struct Image {
+        std::vector<Target> targets;
+        size_t next = 0;            // target being uploaded, the ones before it are done
+        int width = 0;
+        int height = 0;
+        unsigned char* pixels = nullptr;  // RGBA, from DecodeImage(), freed once staged
+        int uploadedRows = 0;
+        bool staged = false;        // copied into the pixel buffer mapped for the next frame
+        size_t offset = 0;          // into that buffer
+    };
+    struct Loading {
+        uint64_t ticket;
+        std::string key;            // of its flight
+    };
+    struct Band {
+        GLuint texture;
+        int x;
+        int y;
+        int rows;
+        int width;
+        size_t offset;              // into the pixel buffer
+    };
+    struct IconRecord {
+        std::string url;
+        uint64_t ticket = 0;        // non-zero while loading
+        bool loaded = false;
+    };
+
+    void Run();
+    unsigned char* Load(const Job& job, int& width, int& height, bool& skipped);
+    bool IsRequested(const Job& job);
+    void Queue(const Target& target, const std::string& key, const std::string& url, int targetWidth = 0, int targetHeight = 0);
+    void Detach(const std::string& key, uint64_t ticket);
+    bool IsLive(const Target& target) const;
+    void Settle(const Target& target, bool loaded);
+    bool PreparePixelBuffers();
+    bool Stage(Image& image);
+
+    HttpTransport& transport;
+    ImageCache imageCache;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping{false};
+
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<Job> jobs;
+    std::deque<Job> prefetches;     // taken only when jobs is empty
+    size_t runningPrefetches = 0;
+    std::unordered_map<std::string, Flight> flights;  // queued and running loads, by url and size
+    uint64_t nextFlight = 1;
+
+    std::mutex imageMutex;
+    std::deque<Image> images;       // uploaded from client memory
+
+    // the pixel buffer mapped for the next frame, workers copy decoded images into it
+    std::mutex stagingMutex;
+    std::condition_variable stagingReady;
+    unsigned char* staging = nullptr;  // null while no buffer is mapped
+    size_t stagingUsed = 0;
+    int stagingWriters = 0;         // copying into staging, it is not unmapped until they are done
+    std::vector<Image> stagedImages;
+    std::atomic<size_t> stagedBytes{0};
+
+    // only touched by the render thread; a texture whose ticket no longer matches was released
+    std::unordered_map<GLuint, Loading> pending;
+    std::unordered_map<GLuint, std::pair<int, int>> sizes;  // width and height of textures given their image
+    uint64_t nextTicket = 1;
+    TextureAtlas atlas;
+    std::vector<IconRecord> icons;  // by atlas entry
+    size_t iconsLoading = 0;
+    Image current{};                // partly uploaded, pixels is null when there is none
+    std::vector<Band> bands;
+    GLuint pixelBuffers[2] = {};
+    unsigned frame = 0;
+    int pixelBufferState = 0;       // 0 not checked yet, 1 in use, -1 unsupported, upload from client memory; written under stagingMutex
+
+    size_t requested = 0;
+    size_t uploaded = 0;
+    std::atomic<size_t> failed{0};
+    std::atomic<size_t> prefetched{0};
+    size_t prefetchesDropped = 0;   // written under jobMutex, read on the render thread that writes it
+    size_t coalesced = 0;           // likewise
+    size_t cancelled = 0;
+    size_t uploadedBytes = 0;
+    std::atomic<uint64_t> decodeMicroseconds{0};
+    double lastFrameMs = 0.0;
+    size_t lastFrameBytes = 0;
+    std::chrono::steady_clock::time_point lastReport;  // of the throttled upload log
+    size_t reportBytes = 0;         // uploaded since lastReport
+    size_t reportFrames = 0;
+    double worstFrameMs = 0.0;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// UTF-8 helpers shared by the search indexes
+
+/**
+ * Length of the UTF-8 sequence at text[pos] and its code point, or 0 if the bytes are not valid UTF-8.
+ */
+inline size_t DecodeUtf8(std::string_view text, size_t pos, uint32_t &codepoint)
+{
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    if (length == 0 || pos + length > text.size())
+    {
+        return 0;
+    }
+    codepoint = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i)
+    {
+        unsigned char next = static_cast<unsigned char>(text[pos + i]);
+        if ((next & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    return length;
+}
+
+inline void AppendUtf8(std::string &out, uint32_t codepoint)
+{
+    if (codepoint < 0x80)
+    {
+        out += static_cast<char>(codepoint);
+    }
+    else if (codepoint < 0x800)
+    {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
@@ -1,15 +1,88 @@
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
 #include <fmt/core.h>
 
 #include "GuiManager.h"
+#include "Benchmark.h"
 
 int main( int argc, char* argv[] )
 {
     std::cout << "Hello, World!" << std::endl;
     fmt::print( "Hello, fmt World!\n" );
 
+    // --prefetch: fill the caches with every champion detail file and exit, for offline exports
+    if ( argc > 1 && std::strcmp( argv[1], "--prefetch" ) == 0 )
+    {
+        DataManager dataManager;
+        if ( !dataManager.FetchStartupData() || !dataManager.PrefetchChampionDetails() )
+        {
+            std::cerr << "Failed to prefetch champion data" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // --bench-items <items.json>: compare DOM and streaming SAX ingestion of the item data
+    if ( argc > 2 && std::strcmp( argv[1], "--bench-items" ) == 0 )
+    {
+        return RunItemIngestBenchmark( argv[2] );
+    }
+
+    // --search <query>: print the champions, items and summoner spells whose names best match the query
+    if ( argc > 2 && std::strcmp( argv[1], "--search" ) == 0 )
+    {
+        DataManager dataManager;
+        if ( !dataManager.FetchStartupData() )
+        {
+            std::cerr << "Failed to load data" << std::endl;
+            return 1;
+        }
+        static const char* const kindNames[] = { "champion", "item", "summoner spell" };
+        for ( const auto& match : dataManager.SearchNames( argv[2] ) )
+        {
+            fmt::print( "{} ({}, {} edits)\n", match.name, kindNames[static_cast<int>( match.kind )], match.distance );
+        }
+        return 0;
+    }
+
+    // --search-text <query>: full-text search over lore, abilities, tips and descriptions
+    if ( argc > 2 && std::strcmp( argv[1], "--search-text" ) == 0 )
+    {
+        DataManager dataManager;
+        if ( !dataManager.FetchStartupData() )
+        {
+            std::cerr << "Failed to load data" << std::endl;
+            return 1;
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto matches = dataManager.SearchText( argv[2] );
+        double ms = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        for ( const auto& match : matches )
+        {
+            fmt::print( "{:6.2f}  {}: {}\n", match.score, match.title, match.text.substr( 0, 100 ) );
+        }
+        fmt::print( "{} results in {:.2f} ms\n", matches.size(), ms );
+        return 0;
+    }
+
     GUIManager guiManager;
 
+    for ( int i = 1; i < argc; ++i )
+    {
+        // --no-sprites: load every champion, ability and summoner spell icon as its own full-size image instead of from sprite sheets
+        if ( std::strcmp( argv[i], "--no-sprites" ) == 0 )
+        {
+            guiManager.SetSpriteSheets( false );
+        }
+        // --texture-budget <MiB>: GPU memory splashes and skins may keep resident before the least recently drawn are evicted
+        else if ( std::strcmp( argv[i], "--texture-budget" ) == 0 && i + 1 < argc )
+        {
+            guiManager.SetTextureBudget( static_cast<size_t>( std::strtoul( argv[++i], nullptr, 10 ) ) << 20 );
+        }
+    }
+
     if ( !guiManager.Initialize( 1280, 720, "League of Legends Item Set Generator" ) )
     {
         std::cerr << "Failed to initialize GUI" << std::endl;